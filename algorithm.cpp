@@ -1,21 +1,38 @@
 #include "algorithm.h"
-#include <unordered_map>
+#include "rank.h"
+#include "openlist.h"
+#include "arena.h"
+#include "pathstore.h"
+#include "statetable.h"
+#include "distancetable.h"
+#include "pdb.h"
+#include "spscqueue.h"
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 using namespace std;
 
 // struct STL-MINHEAP
-struct Node
+template <class Board>
+struct SearchNode
 {
-    string state; // Puzzle
-    string path;  // cost
+    Board state;      // packed board
+    uint32_t pathId;  // entry in the search's PathStore
     int g = 0;
     int h = 0;
     int f = 0;
-    bool alive = true; // Lazy-update
+    bool alive = true;  // Lazy-update
+    int heapIndex = -1; // slot in an indexed OPEN list
 };
 
 // Comparator for Uniform Cost Search (UC):
 struct CmpUC
 {
+    template <class Node>
     bool operator()(const Node *a, const Node *b) const
     {
         return a->g > b->g; // reverse STL to MIN-HEAP
@@ -24,6 +41,7 @@ struct CmpUC
 
 struct CmpAstar
 {
+    template <class Node>
     bool operator()(const Node *a, const Node *b) const
     {
         if (a->f != b->f)
@@ -32,340 +50,1485 @@ struct CmpAstar
     }
 };
 
-// successors list
-vector<pair<string, char>> successors_URDL(Puzzle *cur)
+// what the search knows about one state: the node holding it on OPEN (the
+// handle the OPEN list re-keys) and, once expanded, its best g
+template <class Node>
+struct StateEntry
 {
-    std::vector<std::pair<std::string, char>> res;
+    Node *open = nullptr;
+    int closedG = -1; // -1 if not closed
+};
+
+// OPEN index + CLOSED set in one table keyed by the packed board
+template <class Board>
+struct TableIndex
+{
+    typedef Board Key;
+    typedef StateEntry<SearchNode<Board>> Entry;
+
+    // states a typical 15-puzzle A* query touches; the table grows past it
+    static const size_t EXPECTED_STATES = 1 << 16;
+
+    StateTable<Board, Entry> table;
+
+    TableIndex() : table(EXPECTED_STATES) {}
+
+    Key key(const Board &s) const { return s; }
+
+    // found or added, in one probe sequence; valid until the next call
+    Entry &entry(const Key &k) { return table[k]; }
+
+    // nullptr if k was never added; adds nothing
+    const Entry *find(const Key &k) const { return table.find(k); }
+
+    void clear() { table.clear(); }
+};
+
+// the closed list of the sequential engines: the hash table, except where a
+// board size has a better fit
+template <class Board>
+struct StateIndex : TableIndex<Board>
+{
+};
 
-    // next U
-    if (cur->canMoveUp())
+// 8-puzzle: every state reached shares the start's parity class, so the
+// solvable rank indexes a flat array of entries.  An entry is only valid
+// when it carries the current search's stamp, so clear() is one increment
+// instead of a sweep over all 181440 entries.
+template <>
+struct StateIndex<PackedState>
+{
+    typedef uint32_t Key;
+    typedef StateEntry<SearchNode<PackedState>> Entry;
+
+    vector<Entry> entries;
+    vector<uint32_t> stamp;
+    uint32_t current = 1;
+
+    StateIndex() : entries(NUM_SOLVABLE), stamp(NUM_SOLVABLE, 0) {}
+
+    Key key(const PackedState &s) const { return rankSolvable(s); }
+
+    Entry &entry(Key k)
     {
-        Puzzle *child = cur->moveUp();
-        res.push_back({child->toString(), 'u'});
-        delete child;
+        if (stamp[k] != current) {
+            stamp[k] = current;
+            entries[k] = Entry();
+        }
+        return entries[k];
     }
 
-    // R
-    if (cur->canMoveRight())
+    const Entry *find(Key k) const { return stamp[k] == current ? &entries[k] : nullptr; }
+
+    void clear()
     {
-        Puzzle *child = cur->moveRight();
-        res.push_back({child->toString(), 'r'});
-        delete child;
+        if (++current == 0) { // wrapped: old stamps could match again
+            fill(stamp.begin(), stamp.end(), 0);
+            current = 1;
+        }
     }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Solver contexts: the buffers a Solver keeps for one engine instantiation
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+class SolverContext
+{
+public:
+    virtual ~SolverContext() {}
+};
+
+// a number per context type, handed out on first use
+static atomic<size_t> contextTypes(0);
+
+template <class Context>
+static size_t contextSlot()
+{
+    static const size_t slot = contextTypes++;
+    return slot;
+}
+
+Solver::Solver() {}
+Solver::~Solver() {}
+
+void Solver::release() { contexts.clear(); }
+
+template <class Context>
+Context &Solver::context()
+{
+    const size_t slot = contextSlot<Context>();
+    if (slot >= contexts.size()) contexts.resize(slot + 1);
+    if (!contexts[slot]) contexts[slot].reset(new Context);
+    return static_cast<Context &>(*contexts[slot]);
+}
+
+// the heuristic of the last goal, rebuilt only when the goal changes.  End
+// 0 is the query's goal; MM also keeps one towards the start's canonical
+// board as end 1.
+template <int Rows, int Cols, template <int, int> class Heuristic, int End = 0>
+struct HeuristicContext : SolverContext
+{
+    typedef PackedBoard<Rows, Cols> Board;
+
+    Board goal;
+    unique_ptr<const Heuristic<Rows, Cols>> heuristic;
 
-    // D
-    if (cur->canMoveDown())
+    const Heuristic<Rows, Cols> &forGoal(const Board &g)
     {
-        Puzzle *child = cur->moveDown();
-        res.push_back({child->toString(), 'd'});
-        delete child;
+        if (!heuristic || goal != g) {
+            heuristic.reset();
+            heuristic.reset(new Heuristic<Rows, Cols>(g));
+            goal = g;
+        }
+        return *heuristic;
     }
+};
+
+// OPEN, CLOSED and the nodes of a best-first search
+template <class Node, class OpenList, class Index>
+struct BestFirstContext : SolverContext
+{
+    OpenList openList;
+    Index index;
+    Arena<Node> arena;
+    PathStore paths;
 
-    // L
-    if (cur->canMoveLeft())
+    void clear()
     {
-        Puzzle *child = cur->moveLeft();
-        res.push_back({child->toString(), 'l'});
-        delete child;
+        openList.clear();
+        index.clear();
+        arena.reset();
     }
+};
 
-    return res;
+// the distance table of the last goal not covered by the loaded one
+struct DistanceTableContext : SolverContext
+{
+    DistanceTable table;
+};
+
+// number of cells of a query, checked against the board sizes the engines are built for
+static int boardCells(string const &initialState, string const &goalState)
+{
+    const size_t n = initialState.size();
+    if (n != goalState.size() || (n != 9 && n != 16 && n != 25))
+        throw invalid_argument("states must both have 9, 16 or 25 tiles");
+    return (int)n;
 }
 
-// tools ignore confilct move
-inline bool isInverse(char a, char b)
+// a query renamed onto the canonical goal of its blank square, see GoalRelabeling;
+// engines and tables only ever see canonical goals
+struct Query
+{
+    int cells;
+    string start, goal;
+
+    // the boards the engines search: the only place a query's text is parsed
+    template <int Rows, int Cols>
+    PackedBoard<Rows, Cols> startBoard() const { return PackedBoard<Rows, Cols>::fromString(start); }
+
+    template <int Rows, int Cols>
+    PackedBoard<Rows, Cols> goalBoard() const { return PackedBoard<Rows, Cols>::fromString(goal); }
+};
+
+static Query canonicalQuery(string const &initialState, string const &goalState)
 {
-    return (a == 'u' && b == 'd') || (a == 'd' && b == 'u') || (a == 'l' && b == 'r') || (a == 'r' && b == 'l');
+    Query q;
+    q.cells = boardCells(initialState, goalState);
+
+    const GoalRelabeling relabel(goalState);
+    q.start = relabel.apply(initialState);
+    q.goal = relabel.apply(goalState);
+    if (q.start.empty() || q.goal.empty())
+        throw invalid_argument("start and goal must each hold every tile exactly once");
+    return q;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 //
-// Search Algorithm:  UC with Strict Expanded List
+// Best-first search with a strict expanded list, the core of UC and A*
+//
+// Move Generator: URDL, skipping the move that undoes the one that led here
 //
-// Move Generator:
+// Policies:
+//   OpenList    HeapOpenList, BucketOpenList or IndexedHeapOpenList (openlist.h)
+//   ClosedList  OPEN index + CLOSED set, StateIndex
+//   Heuristic   h of the start and of each child (heuristic.h), ZeroHeuristic for UC
+//   TieBreak    order of OPEN, CmpUC or CmpAstar
+//
+// A node is closed when it is popped.  A child reaching a closed state is
+// dropped unless it gets there with a smaller g, which only an inconsistent
+// heuristic allows; it is then searched again.
 //
 ////////////////////////////////////////////////////////////////////////////////////////////
-string uc_explist(string const initialState, string const goalState,
-                  int &pathLength, int &numOfStateExpansions, int &maxQLength,
-                  float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap,
-                  int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions)
+template <int Rows, int Cols, template <class, class> class OpenList, template <class> class ClosedList,
+          template <int, int> class Heuristic, class TieBreak>
+string bestFirstSearch(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats)
 {
+    typedef PackedBoard<Rows, Cols> Board;
+    typedef SearchNode<Board> Node;
+    typedef ClosedList<Board> Index;
+    typedef BestFirstContext<Node, OpenList<Node, TieBreak>, Index> Context;
+
     // reset stats
-    pathLength = 0; numOfStateExpansions = 0; maxQLength = 0;
-    actualRunningTime = 0.0f;
-    numOfDeletionsFromMiddleOfHeap = 0;
-    numOfLocalLoopsAvoided = 0;
-    numOfAttemptedNodeReExpansions = 0;
+    stats = SearchStats();
 
     clock_t startTime = clock();
 
     // start==goal
-    if (initialState == goalState) {
-        actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
+    if (start == goal) {
+        stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
         return "";
     }
 
-    // OPEN heap + indexes + CLOSED
-    vector<Node*> openHeap;
-    unordered_map<string, Node*> inOpen;
-    unordered_map<string, int>   bestClosedG;
+    // different parity classes -> unreachable, no need to sweep the space
+    if (!isSolvable(start, goal)) {
+        stats.pathLength = UNSOLVABLE;
+        stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
+        return "";
+    }
+
+    // ---- heuristic: full scan for the start, per-move update for children ----
+    const Heuristic<Rows, Cols> &heuristic = solver.context<HeuristicContext<Rows, Cols, Heuristic>>().forGoal(goal);
+
+    // OPEN list + indexes + CLOSED, and the nodes: emptied, not freed
+    Context &context = solver.context<Context>();
+    context.clear();
+    OpenList<Node, TieBreak> &openList = context.openList;
+    Index &index = context.index;
+    Arena<Node> &arena = context.arena;
+    PathStore &paths = context.paths;
 
     // start node
-    Node* start = new Node();
-    start->state = initialState;
-    start->path  = "";
-    start->g = 0; start->h = 0; start->f = 0; start->alive = true;
-
-    openHeap.push_back(start);
-    make_heap(openHeap.begin(), openHeap.end(), CmpUC{});
-    inOpen[start->state] = start;
-    maxQLength = (int)openHeap.size();
-
-    while (!openHeap.empty()) {
-        // pop min-g
-        pop_heap(openHeap.begin(), openHeap.end(), CmpUC{});
-        Node* cur = openHeap.back();
-        openHeap.pop_back();
-
-        // erase current pointer
-        auto itCurOpen = inOpen.find(cur->state);
-        if (itCurOpen != inOpen.end() && itCurOpen->second == cur) {
-            inOpen.erase(itCurOpen);
-        }
+    Node* root = arena.alloc();
+    root->state = start;
+    root->pathId = paths.reset();
+    root->g = 0;
+    root->h = heuristic.evaluate(root->state);
+    root->f = root->g + root->h;
+    root->alive = true;
+    root->heapIndex = -1;
+
+    openList.push(root);
+    index.entry(index.key(root->state)).open = root;
+    stats.maxQLength = (int)openList.size();
+
+    while (!openList.empty()) {
+        // pop the best node by TieBreak
+        Node* cur = openList.pop();
 
         // lazy deletion
         if (!cur->alive) {
-            numOfDeletionsFromMiddleOfHeap++;
-            delete cur;
+            stats.numOfDeletionsFromMiddleOfHeap++;
             continue;
         }
 
-        // only accept min-g
-        if (cur->state == goalState) {
-            string res = std::move(cur->path);
-            pathLength = (int)res.size();
-            actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
-            delete cur;
-            for (Node* nd : openHeap) delete nd;
+        // off OPEN and into CLOSED; no successor of cur can be cur itself
+        typename Index::Entry &curEntry = index.entry(index.key(cur->state));
+        curEntry.open = nullptr;
+        if (curEntry.closedG < 0 || cur->g < curEntry.closedG) curEntry.closedG = cur->g;
+
+        // goal test on expansion: only accept the best g
+        if (cur->state == goal) {
+            string res = paths.path(cur->pathId);
+            stats.pathLength = cur->g;
+            stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
             return res;
         }
 
         // expand
-        numOfStateExpansions++;
+        stats.numOfStateExpansions++;
 
-        // generate URDL successors
-        Puzzle curPuzzle(cur->state, goalState);
-        auto succs = successors_URDL(&curPuzzle);
+        // generate URDL successors, never straight back
+        const Successors<Board> succs(cur->state, pruneMaskAfter(paths.lastMove(cur->pathId)));
+        stats.numOfLocalLoopsAvoided += succs.pruned;
 
-        for (auto &pr : succs) {
-            const string &ns = pr.first;
-            const char mv = pr.second;
+        ChildCosts<Heuristic<Rows, Cols>, Board> costs(heuristic, cur->h, cur->state);
+        for (const auto &child : succs) {
+            const Board ns = child.state;
+            const moveDirection mv = child.move;
 
-            // avoid immediate backtrack
-            if (!cur->path.empty() && isInverse(cur->path.back(), mv)) {
-                numOfLocalLoopsAvoided++;
-                continue;
-            }
-
-            int ng = cur->g + 1;
+            const int ng = cur->g + 1;
+            const int nh = costs.of(ns);
+            const int nf = ng + nh;
+            typename Index::Entry &entry = index.entry(index.key(ns));
 
             // CLOSED: worse/equal path -> drop
-            auto itCns = bestClosedG.find(ns);
-            if (itCns != bestClosedG.end()) {
-                numOfAttemptedNodeReExpansions++;
+            if (entry.closedG >= 0 && ng >= entry.closedG) {
+                stats.numOfAttemptedNodeReExpansions++;
                 continue;
             }
 
             // OPEN: check existing
-            auto itOns = inOpen.find(ns);
-            if (itOns != inOpen.end()) {
-                Node* old = itOns->second;
+            Node* old = entry.open;
+            if (old != nullptr) {
                 if (ng < old->g) {
-                    old->alive = false;               // mark old dead
+                    if (openList.decrease(old, ng, nf)) { // re-keyed in place
+                        stats.numOfDeletionsFromMiddleOfHeap++;
+                        old->pathId = paths.add(cur->pathId, mv);
+                        continue;
+                    }
+                    old->alive = false;                 // mark old dead
                 } else {
-                    numOfAttemptedNodeReExpansions++;
-                    continue;                         
+                    stats.numOfAttemptedNodeReExpansions++;
+                    continue;
                 }
             }
 
             // create child and push
-            Node* nd = new Node();
+            Node* nd = arena.alloc();
             nd->state = ns;
-            nd->path  = cur->path; nd->path.push_back(mv);
-            nd->g = ng; nd->h = 0; nd->f = ng; nd->alive = true;
-
-            openHeap.push_back(nd);
-            push_heap(openHeap.begin(), openHeap.end(), CmpUC{});
-            if ((int)openHeap.size() > maxQLength) maxQLength = (int)openHeap.size();
-            inOpen[ns] = nd;
-        }
+            nd->pathId = paths.add(cur->pathId, mv);
+            nd->g = ng; nd->h = nh; nd->f = nf; nd->alive = true; nd->heapIndex = -1;
 
-        // finished expanding cur -> commit to CLOSED
-        auto itCcur = bestClosedG.find(cur->state);
-        if (itCcur == bestClosedG.end() || cur->g < itCcur->second) {
-            bestClosedG[cur->state] = cur->g;
+            openList.push(nd);
+            if ((int)openList.size() > stats.maxQLength) stats.maxQLength = (int)openList.size();
+            entry.open = nd;
         }
-        delete cur;
     }
 
     // no solution
-    actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
-    for (Node* nd : openHeap) delete nd;
+    stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
     return "";
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Search Algorithm:  UC with Strict Expanded List
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+template <int Rows, int Cols, template <class, class> class OpenList>
+string ucSearch(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats)
+{
+    return bestFirstSearch<Rows, Cols, OpenList, StateIndex, ZeroHeuristic, CmpUC>(solver, start, goal, stats);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 //
 // Search Algorithm:  A* with the Strict Expanded List
 //
-// Move Generator:
+////////////////////////////////////////////////////////////////////////////////////////////
+template <int Rows, int Cols, template <class, class> class OpenList, template <int, int> class Heuristic>
+string aStarSearch(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats)
+{
+    return bestFirstSearch<Rows, Cols, OpenList, StateIndex, Heuristic, CmpAstar>(solver, start, goal, stats);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Search Algorithm:  MM (bidirectional heuristic search that meets in the middle)
+//
+// Holte, Felner, Sharon, Sturtevant (2016).  One search runs forward from
+// the start with h towards the goal, the other backward from the goal with
+// h towards the start; the direction whose OPEN holds the lower priority
+// expands next.  A node's priority is
+//
+//     pr(n) = max(g(n) + h(n), 2 g(n))
+//
+// so neither search goes past the middle of an optimal path before the
+// other gets there.  Each child is looked up on the other side; a hit
+// there is a solution, and U is the cost of the best one so far.  With
+// unit move costs
+//
+//     LB = max(C, fmin forward, fmin backward, gmin forward + gmin backward + 1)
+//
+// where C is the lower of the two smallest priorities, bounds every path
+// not found yet, so the search stops once U <= LB.  Children with
+// g + h >= U are not kept.
+//
+// With ZeroHeuristic pr = 2g and this is bidirectional uniform-cost
+// search, which meets after about half the depth from either end.
+//
+// Goals are canonical and the backward h needs a canonical target too,
+// so it looks at boards through the renaming that makes the start
+// canonical (see GoalRelabeling); distances do not change under it.
+//
+// In the StateIndex of each direction, entry.open holds the node with the
+// state's best g in that direction whether or not it is still on OPEN,
+// and closedG is -1 while it is; the other direction looks up g there.
 //
 ////////////////////////////////////////////////////////////////////////////////////////////
-string aStar_ExpandedList(string const initialState, string const goalState,
-                          int &pathLength, int &numOfStateExpansions, int &maxQLength,
-                          float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap,
-                          int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions,
-                          heuristicFunction heuristic)
+
+// how many open nodes hold each value of a small cost, and the lowest of them
+class CostCounts
 {
-    // reset stats
-    pathLength = 0; numOfStateExpansions = 0; maxQLength = 0;
-    actualRunningTime = 0.0f;
-    numOfDeletionsFromMiddleOfHeap = 0;
-    numOfLocalLoopsAvoided = 0;
-    numOfAttemptedNodeReExpansions = 0;
+    vector<int> count;
+    int lowest = 0;
+    int total = 0;
 
-    clock_t startTime = clock();
+public:
 
-    // early exit
-    if (initialState == goalState) {
-        actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
-        return "";
+    void clear()
+    {
+        fill(count.begin(), count.end(), 0);
+        lowest = 0;
+        total = 0;
     }
 
-    // ---- heuristic helpers (inline) ----
-vector<int> goalPos(10, -1);
-for (int i = 0; i < (int)goalState.size(); i++) {
-    goalPos[goalState[i] - '0'] = i;
+    void add(int v)
+    {
+        if (v >= (int)count.size()) count.resize(v + 1, 0);
+        count[v]++;
+        if (total == 0 || v < lowest) lowest = v;
+        total++;
+    }
+
+    void remove(int v)
+    {
+        count[v]--;
+        total--;
+    }
+
+    // smallest value held; there must be one
+    int min()
+    {
+        while (count[lowest] == 0) lowest++;
+        return lowest;
+    }
+
+    bool empty() const { return total == 0; }
+};
+
+// a board seen with its tiles renamed
+template <class Board>
+struct RenamedBoard
+{
+    const Board *board;
+    const signed char *name; // [tile]
+
+    int tile(int i) const { return name[board->tile(i)]; }
+    int blank() const { return board->blank(); }
+};
+
+// a path from one end run the other way: reversed, each move undone
+static string undonePath(string const &path)
+{
+    string res(path.rbegin(), path.rend());
+    for (char &c : res)
+        c = MOVE_CHAR[inverseOf(moveDirection(find(MOVE_CHAR, MOVE_CHAR + 4, c) - MOVE_CHAR))];
+    return res;
 }
 
-    auto calc_h = [&](const string& s)->int {
-    if (heuristic == misplacedTiles) {
-        int cnt = 0;
-        for (int i = 0; i < 9; ++i) {
-            char ch = s[i];
-            if (ch != '0' && ch != goalState[i]) cnt++;
-        }
-        return cnt;
-    } else { // manhattanDistance
-        int sum = 0;
-        for (int i = 0; i < 9; ++i) {
-            char ch = s[i];
-            if (ch == '0') continue;
-            int gi = goalPos[ch - '0'];
-            int r1 = i / 3, c1 = i % 3;
-            int r2 = gi / 3, c2 = gi % 3;
-            sum += abs(r1 - r2) + abs(c1 - c2);
+template <class Node, class OpenList, class Index>
+struct MeetFrontier
+{
+    OpenList openList;
+    Index index;
+    PathStore paths;
+    CostCounts pr, f, g; // of the live nodes on OPEN
+
+    void clear()
+    {
+        openList.clear();
+        index.clear();
+        pr.clear();
+        f.clear();
+        g.clear();
+    }
+
+    void count(const Node *nd, int sign)
+    {
+        if (sign > 0) {
+            pr.add(nd->f);
+            f.add(nd->g + nd->h);
+            g.add(nd->g);
+        } else {
+            pr.remove(nd->f);
+            f.remove(nd->g + nd->h);
+            g.remove(nd->g);
         }
-        return sum;
     }
 };
-    // OPEN heap + indexes + CLOSED
-    vector<Node*> openHeap;
-    unordered_map<string, Node*> inOpen;
-    unordered_map<string, int>   bestClosedG;
 
-    // start node
-    Node* start = new Node();
-    start->state = initialState;
-    start->path  = "";
-    start->g = 0;
-    start->h = calc_h(initialState);
-    start->f = start->g + start->h;
-    start->alive = true;
-
-    openHeap.push_back(start);
-    make_heap(openHeap.begin(), openHeap.end(), CmpAstar{});
-    inOpen[start->state] = start;
-    maxQLength = (int)openHeap.size();
-
-    while (!openHeap.empty()) {
-        // pop min-f (tie: larger g first via CmpAstar)
-        pop_heap(openHeap.begin(), openHeap.end(), CmpAstar{});
-        Node* cur = openHeap.back();
-        openHeap.pop_back();
-
-        auto itCurOpen = inOpen.find(cur->state);
-        if (itCurOpen != inOpen.end() && itCurOpen->second == cur) {
-            inOpen.erase(itCurOpen);
-        }
+template <class Node, class OpenList, class Index>
+struct MeetContext : SolverContext
+{
+    MeetFrontier<Node, OpenList, Index> side[2]; // forward, backward
+    Arena<Node> arena;
+
+    void clear()
+    {
+        side[0].clear();
+        side[1].clear();
+        arena.reset();
+    }
+};
+
+template <int Rows, int Cols, template <class, class> class OpenList, template <int, int> class Heuristic>
+string mmSearch(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats)
+{
+    typedef PackedBoard<Rows, Cols> Board;
+    typedef SearchNode<Board> Node;
+    typedef StateIndex<Board> Index;
+    typedef MeetFrontier<Node, OpenList<Node, CmpAstar>, Index> Frontier;
+    typedef MeetContext<Node, OpenList<Node, CmpAstar>, Index> Context;
+    const int N = Rows * Cols;
+
+    // reset stats
+    stats = SearchStats();
+
+    clock_t startTime = clock();
+
+    if (start == goal) {
+        stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
+        return "";
+    }
+
+    if (!isSolvable(start, goal)) {
+        stats.pathLength = UNSOLVABLE;
+        stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
+        return "";
+    }
+
+    // h towards the goal, and towards the start through the renaming that
+    // makes the start canonical: tile t of the start becomes the tile the
+    // canonical goal has on t's square
+    const Board target = canonicalBoard<Rows, Cols>(start.blank());
+    signed char name[N];
+    for (int i = 0; i < N; i++) name[start.tile(i)] = (signed char)target.tile(i);
+
+    const Heuristic<Rows, Cols> &forward = solver.context<HeuristicContext<Rows, Cols, Heuristic>>().forGoal(goal);
+    const Heuristic<Rows, Cols> &backward = solver.context<HeuristicContext<Rows, Cols, Heuristic, 1>>().forGoal(target);
+
+    auto hOf = [&](int dir, const Board &b) {
+        return dir == 0 ? forward.evaluate(b) : backward.evaluate(RenamedBoard<Board>{&b, name});
+    };
+
+    Context &context = solver.context<Context>();
+    context.clear();
+    Arena<Node> &arena = context.arena;
+    Frontier *side = context.side;
+
+    const Board ends[2] = {start, goal};
+    for (int dir = 0; dir < 2; dir++) {
+        Node *nd = arena.alloc();
+        nd->state = ends[dir];
+        nd->pathId = side[dir].paths.reset();
+        nd->g = 0;
+        nd->h = hOf(dir, nd->state);
+        nd->f = nd->h;
+        nd->alive = true;
+        nd->heapIndex = -1;
+
+        side[dir].openList.push(nd);
+        side[dir].count(nd, +1);
+        side[dir].index.entry(side[dir].index.key(nd->state)).open = nd;
+    }
+    stats.maxQLength = 2;
+
+    int best = INT_MAX; // U
+    string res;
+
+    while (!side[0].pr.empty() && !side[1].pr.empty()) {
+        const int c = min(side[0].pr.min(), side[1].pr.min());
+        const int lb = max(max(c, side[0].g.min() + side[1].g.min() + 1), max(side[0].f.min(), side[1].f.min()));
+        if (best <= lb) break;
+
+        // the lower priority expands, forward on ties
+        const int dir = side[0].pr.min() <= side[1].pr.min() ? 0 : 1;
+        Frontier &here = side[dir];
+        Frontier &there = side[1 - dir];
+
+        Node *cur = here.openList.pop();
+
         if (!cur->alive) {
-            numOfDeletionsFromMiddleOfHeap++;
-            delete cur;
+            stats.numOfDeletionsFromMiddleOfHeap++;
             continue;
         }
+        here.count(cur, -1);
 
-        if (cur->state == goalState) {
-            string res = std::move(cur->path);
-            pathLength = (int)res.size();
-            actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
-            delete cur;
-            for (Node* nd : openHeap) delete nd;
-            return res;
+        typename Index::Entry &curEntry = here.index.entry(here.index.key(cur->state));
+        if (curEntry.closedG < 0 || cur->g < curEntry.closedG) curEntry.closedG = cur->g;
+
+        stats.numOfStateExpansions++;
+
+        const Successors<Board> succs(cur->state, pruneMaskAfter(here.paths.lastMove(cur->pathId)));
+        stats.numOfLocalLoopsAvoided += succs.pruned;
+
+        // h towards the end the children head for; the other one does no work
+        ChildCosts<Heuristic<Rows, Cols>, Board> forwardCosts(forward, cur->h, cur->state);
+        ChildCosts<Heuristic<Rows, Cols>, RenamedBoard<Board>> backwardCosts(backward, cur->h, RenamedBoard<Board>{&cur->state, name});
+
+        for (const auto &child : succs) {
+            const Board ns = child.state;
+            const moveDirection mv = child.move;
+
+            const int ng = cur->g + 1;
+
+            // reached from the other end too: a solution
+            const typename Index::Entry *far = there.index.find(there.index.key(ns));
+            const Node *met = far != nullptr ? far->open : nullptr;
+            if (met != nullptr && ng + met->g < best) {
+                best = ng + met->g;
+                const string fromHere = here.paths.path(cur->pathId) + MOVE_CHAR[mv];
+                const string fromThere = there.paths.path(met->pathId);
+                res = dir == 0 ? fromHere + undonePath(fromThere) : fromThere + undonePath(fromHere);
+            }
+
+            const int nh = dir == 0 ? forwardCosts.of(ns) : backwardCosts.of(RenamedBoard<Board>{&ns, name});
+            if (ng + nh >= best) continue;
+            const int npr = max(ng + nh, 2 * ng);
+
+            typename Index::Entry &entry = here.index.entry(here.index.key(ns));
+            Node *old = entry.open;
+            if (old != nullptr) {
+                if (ng >= old->g) {
+                    stats.numOfAttemptedNodeReExpansions++;
+                    continue;
+                }
+                if (entry.closedG < 0) { // still on OPEN
+                    here.count(old, -1);
+                    if (here.openList.decrease(old, ng, npr)) {
+                        stats.numOfDeletionsFromMiddleOfHeap++;
+                        old->pathId = here.paths.add(cur->pathId, mv);
+                        here.count(old, +1);
+                        continue;
+                    }
+                    old->alive = false;
+                }
+            }
+
+            // new, cheaper than on OPEN, or reopened
+            Node *nd = arena.alloc();
+            nd->state = ns;
+            nd->pathId = here.paths.add(cur->pathId, mv);
+            nd->g = ng; nd->h = nh; nd->f = npr; nd->alive = true; nd->heapIndex = -1;
+
+            here.openList.push(nd);
+            here.count(nd, +1);
+            entry.open = nd;
+            entry.closedG = -1;
+
+            const int queued = (int)(side[0].openList.size() + side[1].openList.size());
+            if (queued > stats.maxQLength) stats.maxQLength = queued;
         }
+    }
+
+    if (best != INT_MAX) stats.pathLength = best;
+    stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
+    return res;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Search Algorithm:  HDA* (hash-distributed parallel A*)
+//
+// Every state has one owner thread, picked by its hash, and only the owner
+// keeps it on OPEN or CLOSED, so duplicates are caught without sharing a
+// table.  A worker expands its own best node and sends each child to the
+// child's owner through a lock-free queue, one per ordered pair of workers;
+// children that do not fit wait in the sender's outbox.
+//
+// Workers do not expand in global f order, so a state may be expanded before
+// its best g arrives; it is then reopened (see bestFirstSearch).  A goal
+// popped by its owner sets the bound, the cost of the best solution so far,
+// and every node with f >= bound is pruned.  The search ends when no worker
+// has work and no message is in flight: one counter holds the number of
+// active workers plus the messages sent but not yet taken in, and a sender
+// is active when it counts a message, a receiver counts itself active
+// before it takes messages off the count, so the counter only reaches 0
+// once all of them are done.
+//
+// Stats are summed over the workers; maxQLength is the sum of the largest
+// OPEN size of each worker, and actualRunningTime is wall-clock time.
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+const int MAX_HDA_THREADS = 64;
+const size_t HDA_QUEUE_CAPACITY = 256; // messages per pair of workers
+
+// a child on its way to its owner
+template <class Board>
+struct HdaMessage
+{
+    Board state;
+    uint64_t link; // (parent's global id << 2) | move, HDA_ROOT for the start
+    int g, h;
+};
+
+const uint64_t HDA_ROOT = ~uint64_t(0);
+
+template <int Rows, int Cols, template <int, int> class Heuristic>
+string hdaStarSearch(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats, int threads)
+{
+    typedef PackedBoard<Rows, Cols> Board;
+    typedef SearchNode<Board> Node;
+    typedef HdaMessage<Board> Message;
+    typedef TableIndex<Board> Index;
+    typedef chrono::steady_clock Clock;
+
+    // reset stats
+    stats = SearchStats();
+
+    const Clock::time_point startTime = Clock::now();
+    auto elapsed = [&startTime]() { return chrono::duration<float>(Clock::now() - startTime).count(); };
+
+    if (start == goal) {
+        stats.actualRunningTime = elapsed();
+        return "";
+    }
+
+    if (!isSolvable(start, goal)) {
+        stats.pathLength = UNSOLVABLE;
+        stats.actualRunningTime = elapsed();
+        return "";
+    }
+
+    // the calling Solver's, only read by the workers
+    const Heuristic<Rows, Cols> &heuristic = solver.context<HeuristicContext<Rows, Cols, Heuristic>>().forGoal(goal);
+
+    const int workers = threads < 1 ? 1 : (threads > MAX_HDA_THREADS ? MAX_HDA_THREADS : threads);
+
+    vector<unique_ptr<SpscQueue<Message>>> queues; // [from * workers + to]
+    for (int i = 0; i < workers * workers; i++) queues.emplace_back(new SpscQueue<Message>(HDA_QUEUE_CAPACITY));
 
-        numOfStateExpansions++;
-        Puzzle curPuzzle(cur->state, goalState);
-        auto succs = successors_URDL(&curPuzzle);
+    atomic<long> work(workers);   // active workers + messages in flight
+    atomic<int> bound(INT_MAX);   // cost of the best solution so far
+    mutex solutionLock;
+    uint64_t solution = HDA_ROOT; // global id of the best goal node
 
-        for (auto &pr : succs) {
-            const string &ns = pr.first;
-            const char    mv = pr.second;
+    // per worker: stats, and the link of every node it holds, by node id;
+    // a node's global id is (id << 8) | worker
+    vector<SearchStats> workerStats(workers);
+    vector<vector<uint64_t>> links(workers);
 
-            if (!cur->path.empty() && isInverse(cur->path.back(), mv)) {
-                numOfLocalLoopsAvoided++;
+    auto ownerOf = [workers](const Board &b) { return int((b.hash() >> 32) % uint64_t(workers)); };
+
+    auto worker = [&](int me) {
+        IndexedHeapOpenList<Node, CmpAstar> openList;
+        Index index;
+        Arena<Node> arena;
+        SearchStats &st = workerStats[me];
+        vector<uint64_t> &link = links[me];
+        vector<vector<Message>> outbox(workers);
+
+        // a child reaching its owner: the duplicate checks of bestFirstSearch
+        auto insert = [&](const Message &m) {
+            typename Index::Entry &entry = index.entry(index.key(m.state));
+
+            if (entry.closedG >= 0 && m.g >= entry.closedG) {
+                st.numOfAttemptedNodeReExpansions++;
+                return;
+            }
+
+            Node* old = entry.open;
+            if (old != nullptr) {
+                if (m.g < old->g) {
+                    if (openList.decrease(old, m.g, m.g + m.h)) {
+                        st.numOfDeletionsFromMiddleOfHeap++;
+                        old->pathId = (uint32_t)link.size();
+                        link.push_back(m.link);
+                        return;
+                    }
+                    old->alive = false;
+                } else {
+                    st.numOfAttemptedNodeReExpansions++;
+                    return;
+                }
+            }
+
+            Node* nd = arena.alloc();
+            nd->state = m.state;
+            nd->pathId = (uint32_t)link.size();
+            link.push_back(m.link);
+            nd->g = m.g; nd->h = m.h; nd->f = m.g + m.h; nd->alive = true; nd->heapIndex = -1;
+
+            openList.push(nd);
+            if ((int)openList.size() > st.maxQLength) st.maxQLength = (int)openList.size();
+            entry.open = nd;
+        };
+
+        if (ownerOf(start) == me) insert(Message{start, HDA_ROOT, 0, heuristic.evaluate(start)});
+
+        bool active = true;
+        Message m;
+
+        for (;;) {
+            // take in the children the other workers sent
+            long received = 0;
+            for (int from = 0; from < workers; from++) {
+                SpscQueue<Message> &q = *queues[from * workers + me];
+                while (q.pop(m)) {
+                    insert(m);
+                    received++;
+                }
+            }
+            if (received > 0) {
+                if (!active) {
+                    work++;
+                    active = true;
+                }
+                work -= received;
+            }
+
+            // hand on what the outboxes hold
+            bool waiting = false;
+            for (int to = 0; to < workers; to++) {
+                vector<Message> &out = outbox[to];
+                size_t sent = 0;
+                while (sent < out.size() && queues[me * workers + to]->push(out[sent])) sent++;
+                out.erase(out.begin(), out.begin() + sent);
+                if (!out.empty()) waiting = true;
+            }
+
+            // a worker whose peers fall behind waits for them instead of
+            // running ahead on its own part of the space
+            if (waiting) {
+                this_thread::yield();
                 continue;
             }
 
-            const int ng = cur->g + 1;
-            const int nh = calc_h(ns);
-            const int nf = ng + nh;
+            if (!openList.empty()) {
+                Node* cur = openList.pop();
+
+                if (!cur->alive) {
+                    st.numOfDeletionsFromMiddleOfHeap++;
+                    continue;
+                }
+
+                // closed even when pruned: a cheaper g for it reopens it
+                typename Index::Entry &curEntry = index.entry(index.key(cur->state));
+                curEntry.open = nullptr;
+                if (curEntry.closedG < 0 || cur->g < curEntry.closedG) curEntry.closedG = cur->g;
+
+                if (cur->f >= bound.load(memory_order_relaxed)) continue;
+
+                const uint64_t id = (uint64_t(cur->pathId) << 8) | uint64_t(me);
 
-            auto itCns = bestClosedG.find(ns);
-            if (itCns != bestClosedG.end() && ng >= itCns->second) {
-                numOfAttemptedNodeReExpansions++;
+                if (cur->state == goal) {
+                    lock_guard<mutex> hold(solutionLock);
+                    if (cur->g < bound.load()) {
+                        bound.store(cur->g);
+                        solution = id;
+                    }
+                    continue;
+                }
+
+                st.numOfStateExpansions++;
+                const int lastMove = link[cur->pathId] == HDA_ROOT ? -1 : int(link[cur->pathId] & 3);
+
+                const Successors<Board> succs(cur->state, pruneMaskAfter(lastMove));
+                st.numOfLocalLoopsAvoided += succs.pruned;
+
+                ChildCosts<Heuristic<Rows, Cols>, Board> costs(heuristic, cur->h, cur->state);
+                for (const auto &next : succs) {
+                    const Message child = {next.state, (id << 2) | uint64_t(next.move), cur->g + 1, costs.of(next.state)};
+                    if (child.g + child.h >= bound.load(memory_order_relaxed)) continue;
+
+                    const int owner = ownerOf(child.state);
+                    if (owner == me) {
+                        insert(child);
+                    } else {
+                        work++;
+                        outbox[owner].push_back(child);
+                    }
+                }
                 continue;
             }
 
-            auto itOns = inOpen.find(ns);
-            if (itOns != inOpen.end()) {
-                Node* old = itOns->second;
-                if (ng < old->g) {
-                    old->alive = false;  
+            // nothing to do: idle until a message comes, or until no worker
+            // has work and nothing is in flight
+            if (active) {
+                active = false;
+                work--;
+            }
+            if (work.load() == 0) break;
+            this_thread::yield();
+        }
+    };
+
+    vector<thread> pool;
+    for (int w = 1; w < workers; w++) pool.emplace_back(worker, w);
+    worker(0);
+    for (thread &t : pool) t.join();
+
+    for (const SearchStats &st : workerStats) {
+        stats.numOfStateExpansions += st.numOfStateExpansions;
+        stats.maxQLength += st.maxQLength;
+        stats.numOfDeletionsFromMiddleOfHeap += st.numOfDeletionsFromMiddleOfHeap;
+        stats.numOfLocalLoopsAvoided += st.numOfLocalLoopsAvoided;
+        stats.numOfAttemptedNodeReExpansions += st.numOfAttemptedNodeReExpansions;
+    }
+
+    // spell out the path by following the links back across the workers
+    string res;
+    if (solution != HDA_ROOT) {
+        stats.pathLength = bound.load();
+        for (uint64_t id = solution;;) {
+            const uint64_t l = links[id & 255][id >> 8];
+            if (l == HDA_ROOT) break;
+            res.push_back(MOVE_CHAR[l & 3]);
+            id = l >> 2;
+        }
+        reverse(res.begin(), res.end());
+    }
+
+    stats.actualRunningTime = elapsed();
+    return res;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Search Algorithm:  IDA* (iterative-deepening A*)
+//
+// Move Generator: URDL, skipping the move that undoes the previous one
+//
+// A single board is changed in place and restored on backtracking, and an
+// explicit move stack replaces recursion: nothing is allocated during the
+// search and memory grows only with the depth bound.  stats.maxQLength reports
+// the deepest stack reached.
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+const int MAX_IDA_DEPTH = 256;
+
+template <int Rows, int Cols, template <int, int> class Heuristic>
+string idaSearch(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats)
+{
+    typedef Geometry<Rows, Cols> Geo;
+    const int N = Rows * Cols;
+
+    // reset stats
+    stats = SearchStats();
+
+    clock_t startTime = clock();
+
+    if (start == goal) {
+        stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
+        return "";
+    }
+
+    if (!isSolvable(start, goal)) {
+        stats.pathLength = UNSOLVABLE;
+        stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
+        return "";
+    }
+
+    const Heuristic<Rows, Cols> &heuristic = solver.context<HeuristicContext<Rows, Cols, Heuristic>>().forGoal(goal);
+
+    // the one mutable board, and its h kept up to date move by move
+    signed char cells[N], goalCells[N];
+    for (int i = 0; i < N; i++) {
+        cells[i] = (signed char)start.tile(i);
+        goalCells[i] = (signed char)goal.tile(i);
+    }
+    int blank = start.blank();
+    typename Heuristic<Rows, Cols>::Cursor cursor;
+    cursor.reset(heuristic, cells);
+    int h = cursor.value();
+
+    // moveStack[d]: move taken at depth d;  nextDir[d]: last direction tried at depth d
+    signed char moveStack[MAX_IDA_DEPTH];
+    signed char nextDir[MAX_IDA_DEPTH + 1];
+
+    int bound = h;
+    int iterationExpansions = 0;
+
+    while (bound < MAX_IDA_DEPTH) {
+        int nextBound = INT_MAX;
+        int depth = 0;
+        nextDir[0] = -1;
+        iterationExpansions = 0;
+
+        while (depth >= 0) {
+            int d = nextDir[depth] + 1;
+
+            if (d == dirUp) { // first visit of this node
+                const int f = depth + h;
+                if (f > bound) {
+                    if (f < nextBound) nextBound = f;
+                    d = dirLeft + 1; // cut off
+                } else if (h == 0 && memcmp(cells, goalCells, N) == 0) {
+                    string res(depth, ' ');
+                    for (int i = 0; i < depth; i++) res[i] = MOVE_CHAR[moveStack[i]];
+                    stats.pathLength = depth;
+                    stats.numOfAttemptedNodeReExpansions = stats.numOfStateExpansions - iterationExpansions;
+                    stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
+                    return res;
                 } else {
-                    numOfAttemptedNodeReExpansions++;
+                    stats.numOfStateExpansions++;
+                    iterationExpansions++;
+                }
+            }
+
+            // next legal move, never straight back
+            for (; d <= dirLeft; d++) {
+                if (Geo::neighbour(blank, moveDirection(d)) < 0) continue;
+                if (depth > 0 && d == inverseOf(moveDirection(moveStack[depth - 1]))) {
+                    stats.numOfLocalLoopsAvoided++;
                     continue;
                 }
+                break;
             }
+            nextDir[depth] = (signed char)d;
 
-            Node* nd = new Node();
-            nd->state = ns;
-            nd->path  = cur->path; nd->path.push_back(mv);
-            nd->g = ng; nd->h = nh; nd->f = nf; nd->alive = true;
+            if (d <= dirLeft) {
+                // slide the neighbouring tile into the blank
+                const int to = Geo::neighbour(blank, moveDirection(d));
+                const int t = cells[to];
+                cells[blank] = (signed char)t;
+                cells[to] = 0;
+                cursor.moveTile(t, to, blank);
+                h = cursor.value();
+                blank = to;
 
-            openHeap.push_back(nd);
-            push_heap(openHeap.begin(), openHeap.end(), CmpAstar{});
-            if ((int)openHeap.size() > maxQLength) maxQLength = (int)openHeap.size();
-            inOpen[ns] = nd;
+                moveStack[depth] = (signed char)d;
+                depth++;
+                nextDir[depth] = -1;
+                if (depth > stats.maxQLength) stats.maxQLength = depth;
+            } else {
+                // children done: undo the move that led here
+                depth--;
+                if (depth >= 0) {
+                    const int from = Geo::neighbour(blank, inverseOf(moveDirection(moveStack[depth])));
+                    const int t = cells[from];
+                    cells[blank] = (signed char)t;
+                    cells[from] = 0;
+                    cursor.moveTile(t, from, blank);
+                    h = cursor.value();
+                    blank = from;
+                }
+            }
         }
 
-        auto itCcur = bestClosedG.find(cur->state);
-        if (itCcur == bestClosedG.end() || cur->g < itCcur->second) {
-            bestClosedG[cur->state] = cur->g;
-        }
-        delete cur;
+        if (nextBound == INT_MAX) break;
+        bound = nextBound;
     }
 
-    actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
-    for (Node* nd : openHeap) delete nd;
+    // no solution within MAX_IDA_DEPTH
+    stats.numOfAttemptedNodeReExpansions = stats.numOfStateExpansions - iterationExpansions;
+    stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
     return "";
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Distance table (8-puzzle only)
+//
+// The first query for a goal builds the exact distance of every board to it
+// by retrograde BFS; that query and every later one for the same goal are
+// answered by greedy descent through the table, one step per move.  A table
+// loaded from a file with load_table() is used instead of building
+// whenever the goal matches.  Goals are canonical (see canonicalQuery), so
+// there is one table per blank square, not one per goal.
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+static DistanceTable loadedTable; // read-only once loaded, shared by every thread
+
+string tableSearch(Solver &solver, PackedState const &start, PackedState const &goal, SearchStats &stats)
+{
+    // reset stats
+    stats = SearchStats();
+
+    clock_t startTime = clock();
+
+    if (start == goal) {
+        stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
+        return "";
+    }
+
+    DistanceTable &builtTable = solver.context<DistanceTableContext>().table;
+    const DistanceTable *table = &loadedTable;
+    if (!loadedTable.built() || loadedTable.goal() != goal) {
+        if (!builtTable.built() || builtTable.goal() != goal) builtTable.build(goal);
+        table = &builtTable;
+    }
+
+    const int d = table->distance(start);
+    if (d < 0) {
+        stats.pathLength = UNSOLVABLE;
+        stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
+        return "";
+    }
+
+    string res = table->solve(start);
+    stats.pathLength = d;
+    stats.numOfStateExpansions = d; // one descent step per move
+    stats.actualRunningTime = float(clock() - startTime) / CLOCKS_PER_SEC;
+    return res;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Entry points: the board size follows from the length of the state strings
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+// instantiates an engine of one board size with the requested OPEN list
+template <int Rows, int Cols>
+string ucWithOpenList(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats,
+                      openListType openList)
+{
+    switch (openList) {
+    case binaryHeap:
+        return ucSearch<Rows, Cols, HeapOpenList>(solver, start, goal, stats);
+    case bucketQueue:
+        return ucSearch<Rows, Cols, BucketOpenList>(solver, start, goal, stats);
+    default:
+        return ucSearch<Rows, Cols, IndexedHeapOpenList>(solver, start, goal, stats);
+    }
+}
+
+template <int Rows, int Cols, template <int, int> class Heuristic>
+string aStarWithOpenList(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats,
+                         openListType openList)
+{
+    switch (openList) {
+    case binaryHeap:
+        return aStarSearch<Rows, Cols, HeapOpenList, Heuristic>(solver, start, goal, stats);
+    case bucketQueue:
+        return aStarSearch<Rows, Cols, BucketOpenList, Heuristic>(solver, start, goal, stats);
+    default:
+        return aStarSearch<Rows, Cols, IndexedHeapOpenList, Heuristic>(solver, start, goal, stats);
+    }
+}
+
+// one instantiation per heuristic, see heuristic.h
+template <int Rows, int Cols>
+string aStarWithHeuristic(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats,
+                          heuristicFunction heuristic, openListType openList)
+{
+    switch (heuristic) {
+    case misplacedTiles:
+        return aStarWithOpenList<Rows, Cols, MisplacedTilesHeuristic>(solver, start, goal, stats, openList);
+    case patternDatabase:
+        return aStarWithOpenList<Rows, Cols, PatternDatabaseHeuristic>(solver, start, goal, stats, openList);
+    case linearConflict:
+        return aStarWithOpenList<Rows, Cols, LinearConflictHeuristic>(solver, start, goal, stats, openList);
+    case walkingDistance:
+        return aStarWithOpenList<Rows, Cols, WalkingDistanceHeuristic>(solver, start, goal, stats, openList);
+    default:
+        return aStarWithOpenList<Rows, Cols, ManhattanHeuristic>(solver, start, goal, stats, openList);
+    }
+}
+
+template <int Rows, int Cols, template <int, int> class Heuristic>
+string mmWithOpenList(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats,
+                      openListType openList)
+{
+    switch (openList) {
+    case binaryHeap:
+        return mmSearch<Rows, Cols, HeapOpenList, Heuristic>(solver, start, goal, stats);
+    case bucketQueue:
+        return mmSearch<Rows, Cols, BucketOpenList, Heuristic>(solver, start, goal, stats);
+    default:
+        return mmSearch<Rows, Cols, IndexedHeapOpenList, Heuristic>(solver, start, goal, stats);
+    }
+}
+
+template <int Rows, int Cols>
+string mmWithHeuristic(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats,
+                       heuristicFunction heuristic, openListType openList)
+{
+    switch (heuristic) {
+    case misplacedTiles:
+        return mmWithOpenList<Rows, Cols, MisplacedTilesHeuristic>(solver, start, goal, stats, openList);
+    case patternDatabase:
+        return mmWithOpenList<Rows, Cols, PatternDatabaseHeuristic>(solver, start, goal, stats, openList);
+    case linearConflict:
+        return mmWithOpenList<Rows, Cols, LinearConflictHeuristic>(solver, start, goal, stats, openList);
+    case walkingDistance:
+        return mmWithOpenList<Rows, Cols, WalkingDistanceHeuristic>(solver, start, goal, stats, openList);
+    default:
+        return mmWithOpenList<Rows, Cols, ManhattanHeuristic>(solver, start, goal, stats, openList);
+    }
+}
+
+template <int Rows, int Cols>
+string hdaWithHeuristic(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats,
+                        heuristicFunction heuristic, int threads)
+{
+    switch (heuristic) {
+    case misplacedTiles:
+        return hdaStarSearch<Rows, Cols, MisplacedTilesHeuristic>(solver, start, goal, stats, threads);
+    case patternDatabase:
+        return hdaStarSearch<Rows, Cols, PatternDatabaseHeuristic>(solver, start, goal, stats, threads);
+    case linearConflict:
+        return hdaStarSearch<Rows, Cols, LinearConflictHeuristic>(solver, start, goal, stats, threads);
+    case walkingDistance:
+        return hdaStarSearch<Rows, Cols, WalkingDistanceHeuristic>(solver, start, goal, stats, threads);
+    default:
+        return hdaStarSearch<Rows, Cols, ManhattanHeuristic>(solver, start, goal, stats, threads);
+    }
+}
+
+template <int Rows, int Cols>
+string idaWithHeuristic(Solver &solver, PackedBoard<Rows, Cols> const &start, PackedBoard<Rows, Cols> const &goal, SearchStats &stats,
+                        heuristicFunction heuristic)
+{
+    switch (heuristic) {
+    case misplacedTiles:
+        return idaSearch<Rows, Cols, MisplacedTilesHeuristic>(solver, start, goal, stats);
+    case patternDatabase:
+        return idaSearch<Rows, Cols, PatternDatabaseHeuristic>(solver, start, goal, stats);
+    case linearConflict:
+        return idaSearch<Rows, Cols, LinearConflictHeuristic>(solver, start, goal, stats);
+    case walkingDistance:
+        return idaSearch<Rows, Cols, WalkingDistanceHeuristic>(solver, start, goal, stats);
+    default:
+        return idaSearch<Rows, Cols, ManhattanHeuristic>(solver, start, goal, stats);
+    }
+}
+
+static string report(string const &path, SearchStats const &stats, int &pathLength, int &numOfStateExpansions,
+                     int &maxQLength, float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap,
+                     int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions)
+{
+    pathLength = stats.pathLength;
+    numOfStateExpansions = stats.numOfStateExpansions;
+    maxQLength = stats.maxQLength;
+    actualRunningTime = stats.actualRunningTime;
+    numOfDeletionsFromMiddleOfHeap = stats.numOfDeletionsFromMiddleOfHeap;
+    numOfLocalLoopsAvoided = stats.numOfLocalLoopsAvoided;
+    numOfAttemptedNodeReExpansions = stats.numOfAttemptedNodeReExpansions;
+    return path;
+}
+
+string Solver::uc(string const &initialState, string const &goalState, SearchStats &stats, openListType openList)
+{
+    const Query q = canonicalQuery(initialState, goalState);
+
+    switch (q.cells) {
+    case 16:
+        return ucWithOpenList<4, 4>(*this, q.startBoard<4, 4>(), q.goalBoard<4, 4>(), stats, openList);
+    case 25:
+        return ucWithOpenList<5, 5>(*this, q.startBoard<5, 5>(), q.goalBoard<5, 5>(), stats, openList);
+    default:
+        return ucWithOpenList<3, 3>(*this, q.startBoard<3, 3>(), q.goalBoard<3, 3>(), stats, openList);
+    }
+}
+
+string Solver::aStar(string const &initialState, string const &goalState, SearchStats &stats,
+                     heuristicFunction heuristic, openListType openList)
+{
+    const Query q = canonicalQuery(initialState, goalState);
+
+    switch (q.cells) {
+    case 16:
+        return aStarWithHeuristic<4, 4>(*this, q.startBoard<4, 4>(), q.goalBoard<4, 4>(), stats, heuristic, openList);
+    case 25:
+        return aStarWithHeuristic<5, 5>(*this, q.startBoard<5, 5>(), q.goalBoard<5, 5>(), stats, heuristic, openList);
+    default:
+        return aStarWithHeuristic<3, 3>(*this, q.startBoard<3, 3>(), q.goalBoard<3, 3>(), stats, heuristic, openList);
+    }
+}
+
+string Solver::bidirectionalUc(string const &initialState, string const &goalState, SearchStats &stats,
+                               openListType openList)
+{
+    const Query q = canonicalQuery(initialState, goalState);
+
+    switch (q.cells) {
+    case 16:
+        return mmWithOpenList<4, 4, ZeroHeuristic>(*this, q.startBoard<4, 4>(), q.goalBoard<4, 4>(), stats, openList);
+    case 25:
+        return mmWithOpenList<5, 5, ZeroHeuristic>(*this, q.startBoard<5, 5>(), q.goalBoard<5, 5>(), stats, openList);
+    default:
+        return mmWithOpenList<3, 3, ZeroHeuristic>(*this, q.startBoard<3, 3>(), q.goalBoard<3, 3>(), stats, openList);
+    }
+}
+
+string Solver::mm(string const &initialState, string const &goalState, SearchStats &stats,
+                  heuristicFunction heuristic, openListType openList)
+{
+    const Query q = canonicalQuery(initialState, goalState);
+
+    switch (q.cells) {
+    case 16:
+        return mmWithHeuristic<4, 4>(*this, q.startBoard<4, 4>(), q.goalBoard<4, 4>(), stats, heuristic, openList);
+    case 25:
+        return mmWithHeuristic<5, 5>(*this, q.startBoard<5, 5>(), q.goalBoard<5, 5>(), stats, heuristic, openList);
+    default:
+        return mmWithHeuristic<3, 3>(*this, q.startBoard<3, 3>(), q.goalBoard<3, 3>(), stats, heuristic, openList);
+    }
+}
+
+string Solver::idaStar(string const &initialState, string const &goalState, SearchStats &stats,
+                       heuristicFunction heuristic)
+{
+    const Query q = canonicalQuery(initialState, goalState);
+
+    switch (q.cells) {
+    case 16:
+        return idaWithHeuristic<4, 4>(*this, q.startBoard<4, 4>(), q.goalBoard<4, 4>(), stats, heuristic);
+    case 25:
+        return idaWithHeuristic<5, 5>(*this, q.startBoard<5, 5>(), q.goalBoard<5, 5>(), stats, heuristic);
+    default:
+        return idaWithHeuristic<3, 3>(*this, q.startBoard<3, 3>(), q.goalBoard<3, 3>(), stats, heuristic);
+    }
+}
+
+string Solver::hdaStar(string const &initialState, string const &goalState, SearchStats &stats,
+                       heuristicFunction heuristic, int threads)
+{
+    const Query q = canonicalQuery(initialState, goalState);
+
+    switch (q.cells) {
+    case 16:
+        return hdaWithHeuristic<4, 4>(*this, q.startBoard<4, 4>(), q.goalBoard<4, 4>(), stats, heuristic, threads);
+    case 25:
+        return hdaWithHeuristic<5, 5>(*this, q.startBoard<5, 5>(), q.goalBoard<5, 5>(), stats, heuristic, threads);
+    default:
+        return hdaWithHeuristic<3, 3>(*this, q.startBoard<3, 3>(), q.goalBoard<3, 3>(), stats, heuristic, threads);
+    }
+}
+
+string Solver::distanceTable(string const &initialState, string const &goalState, SearchStats &stats)
+{
+    const Query q = canonicalQuery(initialState, goalState);
+    if (q.cells != 9)
+        throw invalid_argument("the distance table covers the 8-puzzle only");
+
+    return tableSearch(*this, q.startBoard<3, 3>(), q.goalBoard<3, 3>(), stats);
+}
+
+// the Solver behind the free functions, one per thread
+static Solver &threadSolver()
+{
+    static thread_local Solver solver;
+    return solver;
+}
+
+string uc_explist(string const initialState, string const goalState,
+                  int &pathLength, int &numOfStateExpansions, int &maxQLength,
+                  float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap,
+                  int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions,
+                  openListType openList)
+{
+    SearchStats stats;
+    string path = threadSolver().uc(initialState, goalState, stats, openList);
+
+    return report(path, stats, pathLength, numOfStateExpansions, maxQLength, actualRunningTime,
+                  numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
+}
+
+string aStar_ExpandedList(string const initialState, string const goalState,
+                          int &pathLength, int &numOfStateExpansions, int &maxQLength,
+                          float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap,
+                          int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions,
+                          heuristicFunction heuristic, openListType openList)
+{
+    SearchStats stats;
+    string path = threadSolver().aStar(initialState, goalState, stats, heuristic, openList);
+
+    return report(path, stats, pathLength, numOfStateExpansions, maxQLength, actualRunningTime,
+                  numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
+}
+
+string bidirectional_uc(string const initialState, string const goalState,
+                        int &pathLength, int &numOfStateExpansions, int &maxQLength,
+                        float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap,
+                        int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions,
+                        openListType openList)
+{
+    SearchStats stats;
+    string path = threadSolver().bidirectionalUc(initialState, goalState, stats, openList);
+
+    return report(path, stats, pathLength, numOfStateExpansions, maxQLength, actualRunningTime,
+                  numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
+}
+
+string mm_search(string const initialState, string const goalState,
+                 int &pathLength, int &numOfStateExpansions, int &maxQLength,
+                 float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap,
+                 int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions,
+                 heuristicFunction heuristic, openListType openList)
+{
+    SearchStats stats;
+    string path = threadSolver().mm(initialState, goalState, stats, heuristic, openList);
+
+    return report(path, stats, pathLength, numOfStateExpansions, maxQLength, actualRunningTime,
+                  numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
+}
+
+string ida_star(string const initialState, string const goalState,
+                int &pathLength, int &numOfStateExpansions, int &maxQLength,
+                float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap,
+                int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions,
+                heuristicFunction heuristic)
+{
+    SearchStats stats;
+    string path = threadSolver().idaStar(initialState, goalState, stats, heuristic);
+
+    return report(path, stats, pathLength, numOfStateExpansions, maxQLength, actualRunningTime,
+                  numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
+}
+
+string hda_star(string const initialState, string const goalState,
+                int &pathLength, int &numOfStateExpansions, int &maxQLength,
+                float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap,
+                int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions,
+                heuristicFunction heuristic, int threads)
+{
+    SearchStats stats;
+    string path = threadSolver().hdaStar(initialState, goalState, stats, heuristic, threads);
+
+    return report(path, stats, pathLength, numOfStateExpansions, maxQLength, actualRunningTime,
+                  numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
+}
+
+string distance_table(string const initialState, string const goalState,
+                      int &pathLength, int &numOfStateExpansions, int &maxQLength,
+                      float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap,
+                      int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions)
+{
+    SearchStats stats;
+    string path = threadSolver().distanceTable(initialState, goalState, stats);
+
+    return report(path, stats, pathLength, numOfStateExpansions, maxQLength, actualRunningTime,
+                  numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
+}
+
+// reads all of a table file and checks it against its checksum
+static bool verifyTable(const MappedTable &file, string const &path, string &error)
+{
+    if (file.checksumOK()) return true;
+    error = path + " fails its checksum";
+    return false;
+}
+
+// maps a file just written and verifies it
+static bool verifyWritten(string const &path, string &error)
+{
+    MappedTable written;
+    return written.open(path, error) && verifyTable(written, path, error);
+}
+
+bool load_table(string const &path, string &error, bool verify)
+{
+    MappedTable probe;
+    if (!probe.open(path, error)) return false;
+    if (verify && !verifyTable(probe, path, error)) return false;
+
+    switch (probe.header().kind) {
+    case distanceTableFile:
+        return loadedTable.load(path, error);
+    case patternDatabaseFile:
+        return PatternDatabase15::loadShared(path, error);
+    }
+    error = path + " holds an unknown kind of table";
+    return false;
+}
+
+bool build_distance_table(string const goalState, string const &path, string &error)
+{
+    const Query q = canonicalQuery(goalState, goalState);
+    if (q.cells != 9)
+        throw invalid_argument("the distance table covers the 8-puzzle only");
+
+    DistanceTable table;
+    table.build(q.goalBoard<3, 3>());
+    return table.save(path, error) && verifyWritten(path, error);
+}
+
+bool build_pattern_database(string const goalState, string const &path, string &error)
+{
+    const Query q = canonicalQuery(goalState, goalState);
+    if (q.cells != 16)
+        throw invalid_argument("pattern databases cover the 15-puzzle only");
+
+    PatternDatabase15 pdb;
+    pdb.build(q.goalBoard<4, 4>());
+    return pdb.save(path, error) && verifyWritten(path, error);
+}
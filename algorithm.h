@@ -8,21 +8,146 @@
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <vector>
 #include "puzzle.h"
 
 
+/////////////////////////////////////////////////////
+
+//pathLength reported when start and goal lie in different parity classes:
+//the query is rejected before any search is done
+const int UNSOLVABLE = -1;
+
+/////////////////////////////////////////////////////
+
+//OPEN list used by uc_explist and aStar_ExpandedList
+//  indexedHeap: binary heap with decrease-key, one entry per open state
+//  binaryHeap:  binary heap, a cheaper path leaves a dead entry behind
+//  bucketQueue: buckets by f and g, dead entries as for binaryHeap
+enum openListType{indexedHeap, binaryHeap, bucketQueue};
+
+//statistics reported by every search engine; where the engines differ, the
+//best-first ones (uc, A*, bidirectional uc, MM, HDA*) come first, then IDA*
+struct SearchStats{
+    int pathLength = 0;
+    int numOfStateExpansions = 0;            //distance table: one per descent step
+    int maxQLength = 0;                      //largest OPEN list (summed over both ends or
+                                             //all HDA* workers); IDA*: deepest move stack
+    float actualRunningTime = 0.0f;
+    int numOfDeletionsFromMiddleOfHeap = 0;  //OPEN entries re-keyed or left stale by a shorter
+                                             //path; IDA*: 0
+    int numOfLocalLoopsAvoided = 0;          //moves straight back not generated
+    int numOfAttemptedNodeReExpansions = 0;  //children dropped as already reached at no greater
+                                             //cost; IDA*: expansions repeating those of earlier
+                                             //iterations
+};
+
+/////////////////////////////////////////////////////
+
+//Reentrant search engines.
+//
+//A Solver owns everything a query needs besides its answer: the OPEN lists,
+//state tables, node arenas and path stores of the best-first engines, and
+//the heuristic or distance table built for the last goal.  Between queries
+//these are cleared, not freed, so a run of queries allocates only while its
+//searches keep growing, and a query with the same goal as the one before
+//skips the goal's precomputation.
+//
+//A Solver may be used by one thread at a time, and may be handed from one
+//thread to another between queries.  Its pattern databases and walking
+//distance tables come from caches shared by every Solver (see pdb.h and
+//walkingdistance.h), which keep the ones of recent goals after release().
+//The free functions below each use one Solver per thread.
+class SolverContext;
+
+class Solver{
+public:
+    Solver();
+    ~Solver();
+    Solver(const Solver &) = delete;
+    Solver &operator=(const Solver &) = delete;
+
+    std::string uc(std::string const &initialState, std::string const &goalState, SearchStats &stats,
+                   openListType openList = indexedHeap);
+    std::string aStar(std::string const &initialState, std::string const &goalState, SearchStats &stats,
+                      heuristicFunction heuristic, openListType openList = indexedHeap);
+    std::string bidirectionalUc(std::string const &initialState, std::string const &goalState, SearchStats &stats,
+                                openListType openList = indexedHeap);
+    std::string mm(std::string const &initialState, std::string const &goalState, SearchStats &stats,
+                   heuristicFunction heuristic, openListType openList = indexedHeap);
+    std::string idaStar(std::string const &initialState, std::string const &goalState, SearchStats &stats,
+                        heuristicFunction heuristic);
+    //the search runs on threads workers of its own; only the heuristic is kept here
+    std::string hdaStar(std::string const &initialState, std::string const &goalState, SearchStats &stats,
+                        heuristicFunction heuristic, int threads);
+    std::string distanceTable(std::string const &initialState, std::string const &goalState, SearchStats &stats);
+
+    //gives back the memory kept for later queries
+    void release();
+
+    //the buffers of one engine instantiation, made on first use (algorithm.cpp)
+    template <class Context> Context &context();
+
+private:
+    std::vector<std::unique_ptr<SolverContext>> contexts;
+};
+
 /////////////////////////////////////////////////////
 
 //Function prototypes
 
 string uc_explist(string const initialState, string const goalState, int& pathLength, int &numOfStateExpansions, int& maxQLength,
-                          float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions);
+                          float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions,
+                          openListType openList = indexedHeap);
 
 
 string aStar_ExpandedList(string const initialState, string const goalState, int& pathLength, int &numOfStateExpansions, int& maxQLength,
+                          float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions, heuristicFunction heuristic,
+                          openListType openList = indexedHeap);
+
+
+//uniform-cost search from both ends at once, meeting in the middle; maxQLength counts both OPEN lists
+string bidirectional_uc(string const initialState, string const goalState, int& pathLength, int &numOfStateExpansions, int& maxQLength,
+                          float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions,
+                          openListType openList = indexedHeap);
+
+
+//MM: bidirectional heuristic search that meets in the middle, stats as for bidirectional_uc
+string mm_search(string const initialState, string const goalState, int& pathLength, int &numOfStateExpansions, int& maxQLength,
+                          float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions, heuristicFunction heuristic,
+                          openListType openList = indexedHeap);
+
+
+//depth-first, allocation-free; maxQLength is the deepest move stack reached
+string ida_star(string const initialState, string const goalState, int& pathLength, int &numOfStateExpansions, int& maxQLength,
                           float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions, heuristicFunction heuristic);
 
 
+//A* spread over threads workers (HDA*); the stats are summed over the workers
+//and actualRunningTime is wall-clock time
+string hda_star(string const initialState, string const goalState, int& pathLength, int &numOfStateExpansions, int& maxQLength,
+                          float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions, heuristicFunction heuristic,
+                          int threads);
+
+
+//8-puzzle only: exact lookup in a table of every board's distance to goalState, built on first use
+string distance_table(string const initialState, string const goalState, int& pathLength, int &numOfStateExpansions, int& maxQLength,
+                          float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions);
+
+//writes the distance table of goalState, relabelled to its canonical goal, to a file, see tablefile.h,
+//and reads it back against its checksum
+bool build_distance_table(string const goalState, string const &path, string &error);
+
+//15-puzzle only: writes the pattern databases of goalState, relabelled to its canonical goal, to a file,
+//and reads it back against its checksum
+bool build_pattern_database(string const goalState, string const &path, string &error);
+
+//maps a file written by build_distance_table or build_pattern_database; distance_table and the
+//patternDatabase heuristic then use it for every goal with the same blank square.  Only the
+//header is checked unless verify, which reads the whole file against its checksum first.
+bool load_table(string const &path, string &error, bool verify = false);
+
+
 
 #endif
\ No newline at end of file
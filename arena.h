@@ -0,0 +1,49 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <cstddef>
+#include <vector>
+
+
+//////////////////////////////////////////////////////
+// Bump allocator for search nodes.
+//
+// Objects are handed out from chunks of CHUNK slots and are never freed
+// one by one: reset() takes the whole arena back at once, keeping its
+// chunks for the next search.  A recycled slot still holds whatever the
+// last search left in it (a string keeps its capacity, for instance), so
+// the caller assigns every member after alloc().
+//////////////////////////////////////////////////////
+template <class T>
+class Arena
+{
+    static const size_t CHUNK = 4096;
+
+    std::vector<T*> chunks;
+    size_t used = 0; // slots handed out since the last reset
+
+public:
+
+    Arena() {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena()
+    {
+        for (T *c : chunks) delete[] c;
+    }
+
+    T *alloc()
+    {
+        const size_t c = used / CHUNK;
+        if (c == chunks.size()) chunks.push_back(new T[CHUNK]);
+        return &chunks[c][used++ % CHUNK];
+    }
+
+    void reset() { used = 0; }
+
+    size_t size() const { return used; }
+};
+
+
+#endif
@@ -0,0 +1,60 @@
+#include "batch.h"
+#include "workpool.h"
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+
+using namespace std;
+
+
+void solve_batch(vector<BatchJob> const &jobs, int threads, BatchReport const &report){
+    if(threads < 1) threads = 1;
+
+    //a job is started only while fewer than window jobs before it are
+    //unreported, which bounds the results held back in waiting.  The job
+    //numbered next is then always running or next in its owner's deque, so
+    //the workers never all wait at once.
+    const size_t window = 4 * size_t(threads);
+
+    mutex reportLock;
+    condition_variable reported;
+    size_t next = 0;                    //first job not yet reported
+    map<size_t, BatchResult> waiting;   //finished ahead of next
+    bool failed = false;                //a job threw: nothing more will be reported
+
+    vector<unique_ptr<Solver>> solvers(threads);
+    for(unique_ptr<Solver> &solver : solvers) solver.reset(new Solver);
+
+    WorkStealingPool::run(jobs.size(), threads, [&](size_t i, int worker){
+        {
+            unique_lock<mutex> guard(reportLock);
+            reported.wait(guard, [&]{ return i < next + window || failed; });
+            if(failed) return;
+        }
+
+        BatchResult result;
+        try{
+            result.path = jobs[i].solve(*solvers[worker], jobs[i].initialState, jobs[i].goalState, result.stats);
+        }
+        catch(...){
+            lock_guard<mutex> guard(reportLock);
+            failed = true;
+            reported.notify_all();
+            throw;
+        }
+
+        lock_guard<mutex> guard(reportLock);
+        if(i != next){
+            waiting.emplace(i, std::move(result));
+            return;
+        }
+        report(jobs[next], result);
+        next++;
+        for(map<size_t, BatchResult>::iterator it = waiting.begin(); it != waiting.end() && it->first == next; it = waiting.erase(it)){
+            report(jobs[next], it->second);
+            next++;
+        }
+        reported.notify_all();
+    });
+}
@@ -0,0 +1,41 @@
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "algorithm.h"
+
+
+/////////////////////////////////////////////////////
+
+//one search of a batch, on the worker's own Solver: returns the path and fills in the stats
+typedef std::function<std::string(Solver &solver, std::string const &initialState, std::string const &goalState, SearchStats &stats)> BatchSolver;
+
+struct BatchJob{
+    std::string algorithm;      //name printed with the result
+    BatchSolver solve;
+    std::string initialState;
+    std::string goalState;
+};
+
+struct BatchResult{
+    std::string path;
+    SearchStats stats;
+};
+
+//receives the results one at a time, in the order of the jobs
+typedef std::function<void(BatchJob const &job, BatchResult const &result)> BatchReport;
+
+/////////////////////////////////////////////////////
+
+//solves every job on a work-stealing pool of threads workers (see workpool.h).
+//Each worker has a Solver of its own and reuses its buffers from one job to
+//the next.  A result is held back until every job before it has been
+//reported, and a worker waits rather than start a job more than a few per
+//thread ahead of the first unreported one, so the results held back stay
+//few however uneven the jobs.
+void solve_batch(std::vector<BatchJob> const &jobs, int threads, BatchReport const &report);
+
+
+#endif
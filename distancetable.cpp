@@ -0,0 +1,97 @@
+#include "distancetable.h"
+#include <cstring>
+#include <stdexcept>
+
+DistanceTable::DistanceTable() : goalBoard(), goalParity(0), dist(nullptr) {}
+
+
+void DistanceTable::build(PackedState goal){
+    file.close();
+    goalBoard = goal;
+    goalParity = tileParity(goal);
+    memory.assign(NUM_SOLVABLE, UNREACHED);
+    dist = memory.data();
+    uint8_t *out = memory.data();
+
+    // level by level: frontier holds the ranks at distance d
+    std::vector<uint32_t> frontier(1, rankSolvable(goal));
+    std::vector<uint32_t> next;
+    out[frontier[0]] = 0;
+
+    for(int d = 0; !frontier.empty(); d++){
+        next.clear();
+        for(uint32_t r : frontier){
+            const PackedState s = unrankSolvable(r, goalParity);
+            for(int m = dirUp; m <= dirLeft; m++){
+                if(!s.canMove(moveDirection(m))) continue;
+                const uint32_t c = rankSolvable(s.moved(moveDirection(m)));
+                if(out[c] != UNREACHED) continue;
+                out[c] = uint8_t(d + 1);
+                next.push_back(c);
+            }
+        }
+        frontier.swap(next);
+    }
+}
+
+
+bool DistanceTable::save(const std::string &path, std::string &error) const {
+    if(!built()){
+        error = "no distance table to save";
+        return false;
+    }
+    TableHeader h;
+    memset(&h, 0, sizeof(h));
+    h.kind = distanceTableFile;
+    h.rows = 3;
+    h.cols = 3;
+    for(int i = 0; i < 9; i++) h.goal[i] = uint8_t(goalBoard.tile(i));
+
+    return writeTableFile(path, h, dist, NUM_SOLVABLE, error);
+}
+
+
+bool DistanceTable::load(const std::string &path, std::string &error){
+    if(!file.open(path, error)) return false;
+
+    const TableHeader &h = file.header();
+    if(h.kind != distanceTableFile || h.rows != 3 || h.cols != 3 || h.entries != NUM_SOLVABLE){
+        error = path + " is not an 8-puzzle distance table";
+    }
+    else {
+        PackedState goal;
+        for(int i = 0; i < 9; i++) goal.set(i, h.goal[i]);
+        goalBoard = goal;
+        goalParity = tileParity(goal);
+        memory.clear();
+        memory.shrink_to_fit();
+        dist = file.data();
+        return true;
+    }
+    file.close();
+    return false;
+}
+
+
+int DistanceTable::distance(PackedState s) const {
+    if(tileParity(s) != goalParity) return -1;
+    return dist[rankSolvable(s)];
+}
+
+
+std::string DistanceTable::solve(PackedState start) const {
+    int d = dist[rankSolvable(start)];
+    std::string path;
+    path.reserve(d);
+
+    PackedState s = start;
+    for(; d > 0; d--){
+        int m = dirUp;
+        while(m <= dirLeft && !(s.canMove(moveDirection(m)) && dist[rankSolvable(s.moved(moveDirection(m)))] == d - 1)) m++;
+        if(m > dirLeft) throw std::runtime_error("distance table is corrupt: no step down from distance " + std::to_string(d));
+        path.push_back(MOVE_CHAR[m]);
+        s = s.moved(moveDirection(m));
+    }
+    if(s != goalBoard) throw std::runtime_error("distance table is corrupt: distance 0 away from its goal");
+    return path;
+}
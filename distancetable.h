@@ -0,0 +1,59 @@
+#ifndef __DISTANCETABLE_H__
+#define __DISTANCETABLE_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "state.h"
+#include "rank.h"
+#include "tablefile.h"
+
+
+//////////////////////////////////////////////////////
+// Exact 8-puzzle distances to one goal.
+//
+// build() runs a breadth-first search backward from the goal over the
+// 9!/2 boards of the goal's parity class (moves are reversible, so the
+// backward search is an ordinary BFS) and stores every board's distance
+// in one byte, indexed by rankSolvable().  The largest distance is 31.
+//
+// solve() then answers a query without searching: from any board some
+// neighbour is one step closer, so stepping to it repeatedly walks an
+// optimal path in O(path length).
+//
+// save() writes the table in the tablefile.h format and load() maps such
+// a file instead of building, taking the goal from its header.
+//////////////////////////////////////////////////////
+class DistanceTable
+{
+    PackedState goalBoard;
+    int goalParity;
+    const uint8_t *dist;          // [rankSolvable], into memory or file
+    std::vector<uint8_t> memory;  // distances when built here
+    MappedTable file;             // distances when loaded
+
+public:
+
+    static const uint8_t UNREACHED = 0xFF;
+
+    DistanceTable();
+
+    void build(PackedState goal);
+
+    bool save(const std::string &path, std::string &error) const;
+    bool load(const std::string &path, std::string &error);
+
+    bool built() const { return dist != nullptr; }
+    PackedState goal() const { return goalBoard; }
+
+    // moves from s to the goal, -1 if s is in the other parity class
+    int distance(PackedState s) const;
+
+    // an optimal move string from start to the goal, in path letters;
+    // start must be solvable (distance(start) >= 0).  Throws runtime_error
+    // if the table leads nowhere, as a corrupt file can.
+    std::string solve(PackedState start) const;
+};
+
+
+#endif
@@ -0,0 +1,331 @@
+#ifndef __HEURISTIC_H__
+#define __HEURISTIC_H__
+
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include "state.h"
+#include "pdb.h"
+#include "linearconflict.h"
+#include "walkingdistance.h"
+
+
+enum heuristicFunction{misplacedTiles, manhattanDistance, patternDatabase, linearConflict, walkingDistance};
+
+
+// share of h for one tile standing on pos whose goal square is goalPos,
+// for misplacedTiles and manhattanDistance: the heuristics that are sums
+// over tiles.  Puzzle::h() refuses the others before asking.
+inline int tileCost(heuristicFunction hFunction, int pos, int goalPos, int cols){
+    if(hFunction == misplacedTiles) return pos != goalPos;
+    return abs(pos / cols - goalPos / cols) + abs(pos % cols - goalPos % cols);
+}
+
+
+// the board of a depth-first engine, one mutable array of tiles
+struct CellsView{
+    const signed char *cells;
+    int tile(int i) const { return cells[i]; }
+};
+
+
+//////////////////////////////////////////////////////
+// Heuristic policies.
+//
+// The engines are templates over one of these, so every instantiation
+// has its heuristic inlined into the search loop; the heuristicFunction
+// enum only picks the instantiation (see algorithm.cpp).  A policy is
+// built once per query from the goal, which must be canonical (see
+// GoalRelabeling), and offers
+//
+//     evaluate(board)                  h of a whole board
+//     childH(parentH, parent, child)   h of a child, one move on; the
+//                                      child's blank is where the moved
+//                                      tile came from
+//     Cursor                           h of the one mutable board of a
+//                                      depth-first engine: reset(policy,
+//                                      cells), moveTile(t, from, to),
+//                                      value()
+//
+// The best-first engines ask for the h of a node's children through one
+// ChildCosts per expansion, below.
+//////////////////////////////////////////////////////
+
+struct ManhattanMetric{
+    static constexpr int between(int p, int q, int cols){
+        return (p / cols > q / cols ? p / cols - q / cols : q / cols - p / cols)
+             + (p % cols > q % cols ? p % cols - q % cols : q % cols - p % cols);
+    }
+};
+
+struct MisplacedMetric{
+    static constexpr int between(int p, int q, int){ return p != q; }
+};
+
+
+// h of the children of one expanded board:
+//
+//     ChildCosts<Policy, Board> costs(policy, parentH, parent);
+//     ... costs.of(child) ...
+//
+// By default every child asks childH(); a policy whose children can share
+// work on the parent specialises it.
+template<class Policy, class Board>
+class ChildCosts{
+    const Policy &policy;
+    int parentH;
+    Board parent;
+public:
+    ChildCosts(const Policy &policy, int parentH, const Board &parent)
+        : policy(policy), parentH(parentH), parent(parent) {}
+    int of(const Board &child){ return policy.childH(parentH, parent, child); }
+};
+
+
+// h as a sum over tiles.  The cost of every tile on every square is
+// worked out by the compiler for each canonical goal, one per blank square.
+template<int Rows, int Cols, class Metric>
+class TileSumHeuristic{
+public:
+
+    static const int N = Rows * Cols;
+
+    struct Table{
+        signed char cost[N][N][N]; // [goal blank][tile][pos]
+
+        constexpr Table() : cost() {
+            for(int b = 0; b < N; b++)
+                for(int t = 1; t < N; t++)
+                    for(int p = 0; p < N; p++)
+                        cost[b][t][p] = (signed char)Metric::between(p, t - 1 < b ? t - 1 : t, Cols);
+        }
+    };
+
+    static constexpr Table TABLE{};
+
+private:
+
+    const signed char (*cost)[N]; // [tile][pos] for this goal
+
+public:
+
+    template<class Board>
+    explicit TileSumHeuristic(const Board &goal) : cost(TABLE.cost[goal.blank()]) {}
+
+    // change in h when tile t slides from square from to square to
+    int delta(int t, int from, int to) const { return cost[t][to] - cost[t][from]; }
+
+    template<class Board>
+    int evaluate(const Board &s) const {
+        int h = 0;
+        for(int i = 0; i < N; i++) h += cost[s.tile(i)][i];
+        return h;
+    }
+
+    template<class Board>
+    int childH(int parentH, const Board &parent, const Board &child) const {
+        const int to = parent.blank();
+        const int from = child.blank();
+        return parentH + delta(child.tile(to), from, to);
+    }
+
+    class Cursor{
+        const TileSumHeuristic *heuristic = nullptr;
+        int h = 0;
+    public:
+        void reset(const TileSumHeuristic &policy, const signed char *cells){
+            heuristic = &policy;
+            h = policy.evaluate(CellsView{cells});
+        }
+        void moveTile(int t, int from, int to){ h += heuristic->delta(t, from, to); }
+        int value() const { return h; }
+    };
+};
+
+template<int Rows, int Cols, class Metric>
+constexpr typename TileSumHeuristic<Rows, Cols, Metric>::Table TileSumHeuristic<Rows, Cols, Metric>::TABLE;
+
+template<int Rows, int Cols>
+using MisplacedTilesHeuristic = TileSumHeuristic<Rows, Cols, MisplacedMetric>;
+
+template<int Rows, int Cols>
+using ManhattanHeuristic = TileSumHeuristic<Rows, Cols, ManhattanMetric>;
+
+
+// no estimate at all: best-first search becomes uniform-cost search
+template<int Rows, int Cols>
+class ZeroHeuristic{
+public:
+
+    template<class Board>
+    explicit ZeroHeuristic(const Board &){}
+
+    template<class Board>
+    int evaluate(const Board &) const { return 0; }
+
+    template<class Board>
+    int childH(int, const Board &, const Board &) const { return 0; }
+
+    struct Cursor{
+        void reset(const ZeroHeuristic &, const signed char *){}
+        void moveTile(int, int, int){}
+        int value() const { return 0; }
+    };
+};
+
+
+// Manhattan distance plus linear conflicts; a move changes the conflicts
+// of the three lines it touches only
+template<int Rows, int Cols>
+class LinearConflictHeuristic{
+
+    ManhattanHeuristic<Rows, Cols> manhattan;
+    LinearConflict<Rows, Cols> conflicts;
+
+public:
+
+    template<class Board>
+    explicit LinearConflictHeuristic(const Board &goal) : manhattan(goal) { conflicts.init(goal); }
+
+    template<class Board>
+    int evaluate(const Board &s) const { return manhattan.evaluate(s) + conflicts.evaluate(s); }
+
+    template<class Board>
+    int childH(int parentH, const Board &parent, const Board &child) const {
+        const int to = parent.blank();
+        const int from = child.blank();
+        return manhattan.childH(parentH, parent, child)
+             + conflicts.linesThrough(child, from, to) - conflicts.linesThrough(parent, from, to);
+    }
+
+    class Cursor{
+        typename ManhattanHeuristic<Rows, Cols>::Cursor distance;
+        ConflictCost<Rows, Cols> conflictCost;
+    public:
+        void reset(const LinearConflictHeuristic &policy, const signed char *cells){
+            distance.reset(policy.manhattan, cells);
+            conflictCost.reset(policy.conflicts, CellsView{cells});
+        }
+        void moveTile(int t, int from, int to){
+            distance.moveTile(t, from, to);
+            conflictCost.moveTile(t, from, to);
+        }
+        int value() const { return distance.value() + conflictCost.value(); }
+    };
+};
+
+
+// walking distance; whole boards are looked up, children and cursors
+// follow the links between matrices
+template<int Rows, int Cols>
+class WalkingDistanceHeuristic{
+
+    std::shared_ptr<const WalkingDistance> byRow, byCol;
+    WalkingCost<Rows, Cols> walking;
+
+    template<class Policy, class Board> friend class ChildCosts;
+
+public:
+
+    template<class Board>
+    explicit WalkingDistanceHeuristic(const Board &goal)
+        : byRow(WalkingDistance::shared(Rows, Cols, goal.blank() / Cols)),
+          byCol(WalkingDistance::shared(Cols, Rows, goal.blank() % Cols)) {
+        walking.init(goal, *byRow, *byCol);
+    }
+
+    template<class Board>
+    int evaluate(const Board &s) const { return walking.evaluate(s); }
+
+    template<class Board>
+    int childH(int, const Board &, const Board &child) const { return walking.evaluate(child); }
+
+    class Cursor{
+        WalkingCost<Rows, Cols> walking;
+    public:
+        void reset(const WalkingDistanceHeuristic &policy, const signed char *cells){
+            walking = policy.walking;
+            walking.reset(CellsView{cells});
+        }
+        void moveTile(int t, int from, int to){ walking.moveTile(t, from, to); }
+        int value() const { return walking.value(); }
+    };
+};
+
+// the parent's two matrices are looked up with the first child; every
+// child is then one link away from them
+template<int Rows, int Cols, class Board>
+class ChildCosts<WalkingDistanceHeuristic<Rows, Cols>, Board>{
+    const WalkingCost<Rows, Cols> &walking;
+    Board parent;
+    int rowId = -1, colId = -1;
+public:
+    ChildCosts(const WalkingDistanceHeuristic<Rows, Cols> &policy, int, const Board &parent)
+        : walking(policy.walking), parent(parent) {}
+    int of(const Board &child){
+        if(rowId < 0) walking.ids(parent, rowId, colId);
+        const int from = child.blank(), to = parent.blank();
+        return walking.valueAfter(rowId, colId, child.tile(to), from, to);
+    }
+};
+
+
+// additive pattern databases, 15-puzzle only: other sizes refuse the query
+template<int Rows, int Cols>
+class PatternDatabaseHeuristic{
+public:
+
+    template<class Board>
+    explicit PatternDatabaseHeuristic(const Board &){
+        throw std::invalid_argument("pattern databases cover the 15-puzzle only");
+    }
+
+    template<class Board>
+    int evaluate(const Board &) const { return 0; }
+
+    template<class Board>
+    int childH(int, const Board &, const Board &) const { return 0; }
+
+    struct Cursor{
+        void reset(const PatternDatabaseHeuristic &, const signed char *){}
+        void moveTile(int, int, int){}
+        int value() const { return 0; }
+    };
+};
+
+template<>
+class PatternDatabaseHeuristic<4, 4>{
+
+    std::shared_ptr<const PatternDatabase15> pdb;
+
+public:
+
+    explicit PatternDatabaseHeuristic(const Board15 &goal) : pdb(PatternDatabase15::forGoal(goal)) {}
+
+    int evaluate(const Board15 &s) const { return pdb->evaluate(s); }
+
+    template<class Board>
+    int evaluate(const Board &s) const {
+        int posOf[16];
+        for(int i = 0; i < 16; i++) posOf[s.tile(i)] = i;
+        return pdb->evaluate(posOf);
+    }
+
+    template<class Board>
+    int childH(int, const Board &, const Board &child) const { return evaluate(child); }
+
+    class Cursor{
+        PatternCost cost;
+    public:
+        void reset(const PatternDatabaseHeuristic &policy, const signed char *cells){
+            int posOf[16];
+            for(int i = 0; i < 16; i++) posOf[cells[i]] = i;
+            cost.reset(*policy.pdb, posOf);
+        }
+        void moveTile(int t, int, int to){ cost.moveTile(t, to); }
+        int value() const { return cost.value(); }
+    };
+};
+
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef __LINEARCONFLICT_H__
+#define __LINEARCONFLICT_H__
+
+#include <cstdint>
+#include <vector>
+
+
+//////////////////////////////////////////////////////
+// Linear conflicts, added on top of Manhattan distance.
+//
+// Two tiles in their goal row (or column) but in the wrong order there
+// must, one of them, leave the line and come back: two moves Manhattan
+// does not count.  The fewest tiles to take out of a line so that the
+// rest are in order is the line's length of tiles minus its longest
+// increasing run of goal positions, so a line costs 2 * (k - LIS).
+//
+// A line is packed into a code with one digit per square, base len+1:
+// the goal position along the line of a tile whose goal is on this line,
+// or len for any other square.  The cost of every code is precomputed.
+//////////////////////////////////////////////////////
+
+// cost of every packed line of len squares
+inline std::vector<uint8_t> buildLineConflicts(int len){
+    int codes = 1;
+    for(int i = 0; i < len; i++) codes *= len + 1;
+    std::vector<uint8_t> table(codes);
+
+    for(int code = 0; code < codes; code++){
+        int seq[8], k = 0;
+        for(int c = 0, v = code; c < len; c++, v /= len + 1)
+            if(v % (len + 1) != len) seq[k++] = v % (len + 1);
+
+        // longest increasing run of goal positions
+        int lis[8], best = 0;
+        for(int i = 0; i < k; i++){
+            lis[i] = 1;
+            for(int j = 0; j < i; j++)
+                if(seq[j] < seq[i] && lis[j] + 1 > lis[i]) lis[i] = lis[j] + 1;
+            if(lis[i] > best) best = lis[i];
+        }
+        table[code] = uint8_t(2 * (k - best));
+    }
+    return table;
+}
+
+inline const uint8_t *lineConflictTable(int len){
+    static const std::vector<uint8_t> tables[6] = {
+        {}, {}, buildLineConflicts(2), buildLineConflicts(3), buildLineConflicts(4), buildLineConflicts(5)};
+    return tables[len].data();
+}
+
+
+template<int Rows, int Cols>
+struct LinearConflict{
+
+    static const int N = Rows * Cols;
+
+    // share of tile t on square p in the code of p's row / column; the
+    // blank and tiles from other lines all weigh as an empty digit
+    int rowWeight[N][N], colWeight[N][N];
+    const uint8_t *rowTable, *colTable;  // by packed row / column
+
+    LinearConflict() : rowTable(nullptr), colTable(nullptr) {}
+
+    template<class Board>
+    void init(const Board &goal){
+        int goalPos[N], rowPow[Cols], colPow[Rows];
+        for(int i = 0; i < N; i++) goalPos[goal.tile(i)] = i;
+        for(int c = 0; c < Cols; c++) rowPow[c] = c == 0 ? 1 : rowPow[c - 1] * (Cols + 1);
+        for(int r = 0; r < Rows; r++) colPow[r] = r == 0 ? 1 : colPow[r - 1] * (Rows + 1);
+
+        for(int t = 0; t < N; t++){
+            const int gr = goalPos[t] / Cols, gc = goalPos[t] % Cols;
+            for(int p = 0; p < N; p++){
+                const int r = p / Cols, c = p % Cols;
+                rowWeight[t][p] = ((t != 0 && gr == r) ? gc : Cols) * rowPow[c];
+                colWeight[t][p] = ((t != 0 && gc == c) ? gr : Rows) * colPow[r];
+            }
+        }
+        rowTable = lineConflictTable(Cols);
+        colTable = lineConflictTable(Rows);
+    }
+
+    template<class Cells>
+    int rowCode(const Cells &b, int r) const {
+        int code = 0;
+        for(int p = r * Cols; p < (r + 1) * Cols; p++) code += rowWeight[b.tile(p)][p];
+        return code;
+    }
+
+    template<class Cells>
+    int colCode(const Cells &b, int c) const {
+        int code = 0;
+        for(int p = c; p < N; p += Cols) code += colWeight[b.tile(p)][p];
+        return code;
+    }
+
+    template<class Cells>
+    int evaluate(const Cells &b) const {
+        int h = 0;
+        for(int r = 0; r < Rows; r++) h += rowTable[rowCode(b, r)];
+        for(int c = 0; c < Cols; c++) h += colTable[colCode(b, c)];
+        return h;
+    }
+
+    // cost of the lines through the adjacent squares p and q: the only
+    // lines a move between p and q can change
+    template<class Cells>
+    int linesThrough(const Cells &b, int p, int q) const {
+        if(p / Cols == q / Cols)
+            return rowTable[rowCode(b, p / Cols)] + colTable[colCode(b, p % Cols)] + colTable[colCode(b, q % Cols)];
+        return colTable[colCode(b, p % Cols)] + rowTable[rowCode(b, p / Cols)] + rowTable[rowCode(b, q / Cols)];
+    }
+};
+
+
+//////////////////////////////////////////////////////
+// Linear conflicts of one board, kept up to date move by move: a move
+// changes one digit in each of the lines it leaves and enters, so the
+// codes are patched in place and only those lines are looked up again.
+//////////////////////////////////////////////////////
+template<int Rows, int Cols>
+class ConflictCost
+{
+    static const int N = Rows * Cols;
+
+    const LinearConflict<Rows, Cols> *lc = nullptr;
+    int rowCode[Rows], colCode[Cols];
+    int total = 0;
+
+public:
+
+    template<class Cells>
+    void reset(const LinearConflict<Rows, Cols> &conflicts, const Cells &b){
+        lc = &conflicts;
+        total = 0;
+        for(int r = 0; r < Rows; r++){
+            rowCode[r] = lc->rowCode(b, r);
+            total += lc->rowTable[rowCode[r]];
+        }
+        for(int c = 0; c < Cols; c++){
+            colCode[c] = lc->colCode(b, c);
+            total += lc->colTable[colCode[c]];
+        }
+    }
+
+    // tile t slid from square from to the neighbouring square to
+    void moveTile(int t, int from, int to){
+        const int fr = from / Cols, fc = from % Cols, tr = to / Cols, tc = to % Cols;
+        const int leaveRow = lc->rowWeight[0][from] - lc->rowWeight[t][from];
+        const int enterRow = lc->rowWeight[t][to] - lc->rowWeight[0][to];
+        const int leaveCol = lc->colWeight[0][from] - lc->colWeight[t][from];
+        const int enterCol = lc->colWeight[t][to] - lc->colWeight[0][to];
+
+        if(fr == tr){
+            total -= lc->rowTable[rowCode[fr]] + lc->colTable[colCode[fc]] + lc->colTable[colCode[tc]];
+            rowCode[fr] += leaveRow + enterRow;
+            colCode[fc] += leaveCol;
+            colCode[tc] += enterCol;
+            total += lc->rowTable[rowCode[fr]] + lc->colTable[colCode[fc]] + lc->colTable[colCode[tc]];
+        } else {
+            total -= lc->colTable[colCode[fc]] + lc->rowTable[rowCode[fr]] + lc->rowTable[rowCode[tr]];
+            colCode[fc] += leaveCol + enterCol;
+            rowCode[fr] += leaveRow;
+            rowCode[tr] += enterRow;
+            total += lc->colTable[colCode[fc]] + lc->rowTable[rowCode[fr]] + lc->rowTable[rowCode[tr]];
+        }
+    }
+
+    int value() const { return total; }
+};
+
+
+#endif
@@ -22,6 +22,8 @@
 #include <exception>
 #include <chrono>
 #include <string>
+#include <thread>
+#include <vector>
     
    
 
@@ -30,6 +32,7 @@
     #include <graphics.h>
 
     #include "algorithm.h"
+    #include "batch.h"
 
 #elif defined __WIN32__
 
@@ -38,6 +41,7 @@
 
     #include "graphics.h"
     #include "algorithm.h"
+    #include "batch.h"
 
 #endif
 
@@ -48,7 +52,17 @@ string list_of_initialStates[5] = { "120483765","208135467","704851632","5364071
 string goalState = string("123456780");
 //////////////////////////////////////////////////////////////////////////////////////////////////////
 
-int g_local_loops_avoided;
+// OPEN list of uc_explist and the A* runs, chosen with --open=indexed|heap|buckets
+openListType g_open_list = indexedHeap;
+
+// precomputed table file given with --table=PATH
+string g_table_path;
+
+// the --table file read whole against its checksum before use, --verify
+bool g_verify_table = false;
+
+// worker threads of the hdastar and batch runs, --threads=N; one per core by default
+int g_threads = std::thread::hardware_concurrency() > 0 ? (int)std::thread::hardware_concurrency() : 1;
 
 #define OUTPUT_LENGTH 2 /* Length of output string. */
 
@@ -259,41 +273,32 @@ void AnimateSolution(string const initialState, string const goalState, string p
         cout << "Plan of action = " << path << endl;
     }
     
-    Puzzle *p = new Puzzle(initialState, goalState);
-    Puzzle *nextState=NULL;
+    static const char *MOVE_NAME[4] = {"[UP]", "[RIGHT]", "[DOWN]", "[LEFT]"};
+
+    Puzzle8 p(initialState, goalState);
     
     string strState;
         
-    strState = p->toString();
+    strState = p.toString();
     displayBoard(strState);
     
     cout << "--------------------------------------------------------------------" << endl;
           
     for(long long unsigned int i=0; i < path.length(); i++){
         
-       cout << endl << "Step #" << step << ")  ";
-       switch(path[i]){
-            
-            case 'U': nextState = p->moveUp(); cout << "[UP]" << endl;
-                      break;
-            case 'D': nextState = p->moveDown(); cout << "[DOWN]" << endl;
-                      break;
-            case 'L': nextState = p->moveLeft(); cout << "[LEFT]" << endl;
-                      break;
-            case 'R': nextState = p->moveRight(); cout << "[RIGHT]" << endl;
-                      break;
-      }
-      strState = nextState->toString();
-        
-      delete p;
-      p = nextState;
+       int dir = directionOf(path[i]);
+       if(dir < 0 || !p.canMove(moveDirection(dir))) break;
+
+       cout << endl << "Step #" << step << ")  " << MOVE_NAME[dir] << endl;
+       p.applyMove(moveDirection(dir));
+
+       strState = p.toString();
         
       displayBoard(strState);
       
       step++;
     }
     
-    delete p; //clear memory    
     cout << endl << "Animation done." << endl;
     cout << "--------------------------------------------------------------------" << endl;
     
@@ -302,277 +307,130 @@ void AnimateSolution(string const initialState, string const goalState, string p
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
-void run_all_experiments() {
-
-    int num_of_init_states = sizeof(list_of_initialStates) / sizeof(list_of_initialStates[0]);
+// The batch drivers solve every (algorithm, initial state) pair on g_threads workers and print
+// the rows in the order of the jobs, however the workers finish.
 
-    int pathLength = 0;
-    // int depth = 0;
-    int numOfStateExpansions = 0;
-    int maxQLength = 0;
-    int numOfDeletionsFromMiddleOfHeap = 0;
-    int numOfLocalLoopsAvoided = 0;
-    int numOfAttemptedNodeReExpansions = 0;
-    float actualRunningTime = 0.0;
-
-    string initialState;
-
-    std::cout << "ALGORITHM,               INIT_STATE,            GOAL_STATE,       PATH_LENGTH,     STATE_EXPANSIONS,  MAX_QLENGTH,  RUNNING_TIME,  DELETIONS_MIDDLE_HEAP, LOCAL_LOOPS_AVOIDED, ATTEMPTED_REEXPANSIONS,   PATH,  COMMENTS" << endl;
-
-    //---
-    for (int j = 0; j < num_of_init_states; j++) {
+BatchSolver uc_solver(){
+    return [](Solver &solver, string const &initialState, string const &goalState, SearchStats &stats){
+        return solver.uc(initialState, goalState, stats, g_open_list);
+    };
+}
 
-        initialState = list_of_initialStates[j];
-
-        string path;
-        path.clear();
-        pathLength = 0;
-        // depth = 0;
-        numOfStateExpansions = 0;
-        maxQLength = 0;
-        numOfDeletionsFromMiddleOfHeap = 0;
-        numOfLocalLoopsAvoided = 0;
-        numOfAttemptedNodeReExpansions = 0;
-        actualRunningTime = 0.0;
-        path = uc_explist(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
-
-
-        std::cout << setw(21) << "uniform_cost_search";
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfStateExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << maxQLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << actualRunningTime;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfDeletionsFromMiddleOfHeap;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfLocalLoopsAvoided;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfAttemptedNodeReExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << path << endl;
-
-
-    } //End - For loop
-    //---
-    for (int j = 0; j < num_of_init_states; j++) {
+BatchSolver astar_solver(heuristicFunction heuristic){
+    return [heuristic](Solver &solver, string const &initialState, string const &goalState, SearchStats &stats){
+        return solver.aStar(initialState, goalState, stats, heuristic, g_open_list);
+    };
+}
 
-        initialState = list_of_initialStates[j];
-
-        string path;
-        path.clear();
-        pathLength = 0;
-        // depth = 0;
-        numOfStateExpansions = 0;
-        maxQLength = 0;
-        numOfDeletionsFromMiddleOfHeap = 0;
-        numOfLocalLoopsAvoided = 0;
-        numOfAttemptedNodeReExpansions = 0;
-        actualRunningTime = 0.0;
-        path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, misplacedTiles);
-
-                                  
-        std::cout << setw(21) << "astar_misplacedtiles";
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfStateExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << maxQLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << actualRunningTime;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfDeletionsFromMiddleOfHeap;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfLocalLoopsAvoided;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfAttemptedNodeReExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << path << endl;
-
-
-     } //End - For loop
-    //---
-    for (int j = 0; j < num_of_init_states; j++) {
+BatchSolver idastar_solver(heuristicFunction heuristic){
+    return [heuristic](Solver &solver, string const &initialState, string const &goalState, SearchStats &stats){
+        return solver.idaStar(initialState, goalState, stats, heuristic);
+    };
+}
 
-        initialState = list_of_initialStates[j];
-
-        string path;
-        path.clear();
-        pathLength = 0;
-        // depth = 0;
-        numOfStateExpansions = 0;
-        maxQLength = 0;
-        numOfDeletionsFromMiddleOfHeap = 0;
-        numOfLocalLoopsAvoided = 0;
-        numOfAttemptedNodeReExpansions = 0;
-        actualRunningTime = 0.0;
-        path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, manhattanDistance);
-
-                                  
-        std::cout << setw(21) << "astar_manhattan";
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfStateExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << maxQLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << actualRunningTime;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfDeletionsFromMiddleOfHeap;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfLocalLoopsAvoided;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfAttemptedNodeReExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << path << endl;
-
-
-    } //End - For loop
+BatchSolver bidirectional_uc_solver(){
+    return [](Solver &solver, string const &initialState, string const &goalState, SearchStats &stats){
+        return solver.bidirectionalUc(initialState, goalState, stats, g_open_list);
+    };
+}
 
+BatchSolver mm_solver(heuristicFunction heuristic){
+    return [heuristic](Solver &solver, string const &initialState, string const &goalState, SearchStats &stats){
+        return solver.mm(initialState, goalState, stats, heuristic, g_open_list);
+    };
 }
 
+BatchSolver distance_table_solver(){
+    return [](Solver &solver, string const &initialState, string const &goalState, SearchStats &stats){
+        return solver.distanceTable(initialState, goalState, stats);
+    };
+}
 
-///////////////////////////////////////////////////////////////////////////////////////////////
-void run_uc_experiments() {
+// one job per initial state, in list order
+void add_experiments(vector<BatchJob> &jobs, string const &algorithm, BatchSolver const &solve) {
 
     int num_of_init_states = sizeof(list_of_initialStates) / sizeof(list_of_initialStates[0]);
 
-    int pathLength = 0;
-    // int depth = 0;
-    int numOfStateExpansions = 0;
-    int maxQLength = 0;
-    int numOfDeletionsFromMiddleOfHeap = 0;
-    int numOfLocalLoopsAvoided = 0;
-    int numOfAttemptedNodeReExpansions = 0;
-    float actualRunningTime = 0.0;
-
-    string initialState;
-
-    std::cout << "ALGORITHM,               INIT_STATE,            GOAL_STATE,       PATH_LENGTH,     STATE_EXPANSIONS,  MAX_QLENGTH,  RUNNING_TIME,  DELETIONS_MIDDLE_HEAP, LOCAL_LOOPS_AVOIDED, ATTEMPTED_REEXPANSIONS,   PATH" << endl;
-
     for (int j = 0; j < num_of_init_states; j++) {
+        jobs.push_back(BatchJob{algorithm, solve, list_of_initialStates[j], goalState});
+    }
+}
 
-        initialState = list_of_initialStates[j];
+// widths: algorithm name, then the ten columns after it
+void run_experiments(vector<BatchJob> const &jobs, const int widths[11]) {
+
+    solve_batch(jobs, g_threads, [widths](BatchJob const &job, BatchResult const &result){
+        SearchStats const &s = result.stats;
+
+        std::cout << setw(widths[0]) << job.algorithm;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(widths[1]) << "," << job.initialState;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(widths[2]) << "," << job.goalState;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(widths[3]) << "," << s.pathLength;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(widths[4]) << "," << s.numOfStateExpansions;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(widths[5]) << "," << s.maxQLength;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(widths[6]) << "," << s.actualRunningTime;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(widths[7]) << "," << s.numOfDeletionsFromMiddleOfHeap;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(widths[8]) << "," << s.numOfLocalLoopsAvoided;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(widths[9]) << "," << s.numOfAttemptedNodeReExpansions;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(widths[10]) << "," << result.path << endl;
+    });
+}
 
-        string path;
-        path.clear();
-        pathLength = 0;
-        // depth = 0;
-        numOfStateExpansions = 0;
-        maxQLength = 0;
-        numOfDeletionsFromMiddleOfHeap = 0;
-        numOfLocalLoopsAvoided = 0;
-        numOfAttemptedNodeReExpansions = 0;
-        actualRunningTime = 0.0;
-        path = uc_explist(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
+const int ALL_WIDTHS[11]    = { 21, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10 };
+const int SINGLE_WIDTHS[11] = { 16, 10, 10, 10, 13, 15, 15, 15, 20, 15, 15 };
 
 
-        std::cout << setw(16) << "uniform_cost_search";
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(13) << "," << numOfStateExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << maxQLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << actualRunningTime;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfDeletionsFromMiddleOfHeap;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(20) << "," << numOfLocalLoopsAvoided;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfAttemptedNodeReExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << path << endl;
+///////////////////////////////////////////////////////////////////////////////////////////////
+void run_all_experiments() {
 
+    std::cout << "ALGORITHM,               INIT_STATE,            GOAL_STATE,       PATH_LENGTH,     STATE_EXPANSIONS,  MAX_QLENGTH,  RUNNING_TIME,  DELETIONS_MIDDLE_HEAP, LOCAL_LOOPS_AVOIDED, ATTEMPTED_REEXPANSIONS,   PATH,  COMMENTS" << endl;
 
-    } //End - For loop
+    vector<BatchJob> jobs;
+    add_experiments(jobs, "uniform_cost_search", uc_solver());
+    add_experiments(jobs, "astar_misplacedtiles", astar_solver(misplacedTiles));
+    add_experiments(jobs, "astar_manhattan", astar_solver(manhattanDistance));
+    run_experiments(jobs, ALL_WIDTHS);
 
 }
 
-///////////////////////////////////////////////////////////////////////////////////////////////
-void run_astar_manhattan_experiments() {
-
-    int num_of_init_states = sizeof(list_of_initialStates) / sizeof(list_of_initialStates[0]);
-
-    int pathLength = 0;
-    // int depth = 0;
-    int numOfStateExpansions = 0;
-    int maxQLength = 0;
-    int numOfDeletionsFromMiddleOfHeap = 0;
-    int numOfLocalLoopsAvoided = 0;
-    int numOfAttemptedNodeReExpansions = 0;
-    float actualRunningTime = 0.0;
 
-    string initialState; 
+///////////////////////////////////////////////////////////////////////////////////////////////
+void run_single_experiments(string const &algorithm, BatchSolver const &solve) {
 
     std::cout << "ALGORITHM,               INIT_STATE,            GOAL_STATE,       PATH_LENGTH,     STATE_EXPANSIONS,  MAX_QLENGTH,  RUNNING_TIME,  DELETIONS_MIDDLE_HEAP, LOCAL_LOOPS_AVOIDED, ATTEMPTED_REEXPANSIONS,   PATH" << endl;
 
-    for (int j = 0; j < num_of_init_states; j++) {
+    vector<BatchJob> jobs;
+    add_experiments(jobs, algorithm, solve);
+    run_experiments(jobs, SINGLE_WIDTHS);
 
-            initialState = list_of_initialStates[j];
+}
 
-            string path;
-            path.clear();
-            pathLength = 0;
-            // depth = 0;
-            numOfStateExpansions = 0;
-            maxQLength = 0;
-            numOfDeletionsFromMiddleOfHeap = 0;
-            numOfLocalLoopsAvoided = 0;
-            numOfAttemptedNodeReExpansions = 0;
-            actualRunningTime = 0.0;
-            path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, manhattanDistance);
+void run_uc_experiments() {
+    run_single_experiments("uniform_cost_search", uc_solver());
+}
 
-            
-            std::cout << setw(16) << "astar_manhattan";
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(13) << "," << numOfStateExpansions;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << maxQLength;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << actualRunningTime;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfDeletionsFromMiddleOfHeap;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(20) << "," << numOfLocalLoopsAvoided;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfAttemptedNodeReExpansions;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << path << endl;
-            
+void run_astar_manhattan_experiments() {
+    run_single_experiments("astar_manhattan", astar_solver(manhattanDistance));
+}
 
-    } //End - For loop
+void run_idastar_manhattan_experiments() {
+    run_single_experiments("idastar_manhattan", idastar_solver(manhattanDistance));
+}
 
+void run_distance_table_experiments() {
+    run_single_experiments("distance_table", distance_table_solver());
 }
 
-///////////////////////////////////////////////////////////////////////////////////////////////
 void run_astar_misplaced_tiles_experiments() {
+    run_single_experiments("astar_misplacedtiles", astar_solver(misplacedTiles));
+}
 
-    int num_of_init_states = sizeof(list_of_initialStates) / sizeof(list_of_initialStates[0]);
-
-    int pathLength = 0;
-    // int depth = 0;
-    int numOfStateExpansions = 0;
-    int maxQLength = 0;
-    int numOfDeletionsFromMiddleOfHeap = 0;
-    int numOfLocalLoopsAvoided = 0;
-    int numOfAttemptedNodeReExpansions = 0;
-    float actualRunningTime = 0.0;
-
-    string initialState;
-
-    std::cout << "ALGORITHM,               INIT_STATE,            GOAL_STATE,       PATH_LENGTH,     STATE_EXPANSIONS,  MAX_QLENGTH,  RUNNING_TIME,  DELETIONS_MIDDLE_HEAP, LOCAL_LOOPS_AVOIDED, ATTEMPTED_REEXPANSIONS,   PATH" << endl;
-
-    for (int j = 0; j < num_of_init_states; j++) {
-
-        initialState = list_of_initialStates[j];
-
-        string path;
-        path.clear();
-        pathLength = 0;
-        // depth = 0;
-        numOfStateExpansions = 0;
-        maxQLength = 0;
-        numOfDeletionsFromMiddleOfHeap = 0;
-        numOfLocalLoopsAvoided = 0;
-        numOfAttemptedNodeReExpansions = 0;
-        actualRunningTime = 0.0;
-        path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, misplacedTiles);
-
-
-        std::cout << setw(16) << "astar_misplacedtiles";
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(13) << "," << numOfStateExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << maxQLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << actualRunningTime;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfDeletionsFromMiddleOfHeap;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(20) << "," << numOfLocalLoopsAvoided;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfAttemptedNodeReExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << path << endl;
-
-
-    } //End - For loop
+void run_bidirectional_uc_experiments() {
+    run_single_experiments("bidirectional_uc", bidirectional_uc_solver());
+}
 
+void run_mm_manhattan_experiments() {
+    run_single_experiments("mm_manhattan", mm_solver(manhattanDistance));
 }
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -584,9 +442,50 @@ void run_astar_misplaced_tiles_experiments() {
 
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+// Handles the "--name=value" options, which may appear anywhere on the command line,
+// and removes them from argv.  Returns the number of remaining arguments.
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+int parseOptions(int argc, char* argv[]){
+    int kept = 0;
+
+    for(int i = 0; i < argc; i++){
+        string arg(argv[i]);
+
+        if(i == 0 || arg.compare(0, 2, "--") != 0){
+            argv[kept++] = argv[i];
+        }
+        else if(arg == "--open=indexed"){
+            g_open_list = indexedHeap;
+        }
+        else if(arg == "--open=heap"){
+            g_open_list = binaryHeap;
+        }
+        else if(arg == "--open=buckets"){
+            g_open_list = bucketQueue;
+        }
+        else if(arg.compare(0, 8, "--table=") == 0){
+            g_table_path = arg.substr(8);
+        }
+        else if(arg == "--verify"){
+            g_verify_table = true;
+        }
+        else if(arg.compare(0, 10, "--threads=") == 0 && atoi(arg.c_str() + 10) > 0){
+            g_threads = atoi(arg.c_str() + 10);
+        }
+        else {
+            cout << "unknown option " << arg << " (ignored)" << endl;
+        }
+    }
+    return kept;
+}
+
+
 int main( int argc, char* argv[] ){
    
    string path;
+
+   argc = parseOptions(argc, argv);
   
 
 	if(argc < 3){
@@ -594,6 +493,11 @@ int main( int argc, char* argv[] ){
 		cout << "please include missing parameters." << endl;
         cout << "SYNTAX #1: search.exe <TYPE_OF_RUN = \"batch_run\" or \"single_run\" or \"animate_run\"> ALGORITHM_NAME \"INITIAL STATE\" \"GOAL STATE\" " << endl;
         cout << "SYNTAX #2: search.exe <TYPE_OF_RUN = \"batch_run\"> ALGORITHM_NAME" << endl;
+        cout << "SYNTAX #3: search.exe build_table <distance_table or pdb_555> \"GOAL STATE\" TABLE_FILE" << endl;
+        cout << "OPTIONS:   --open=indexed (default), --open=heap or --open=buckets" << endl;
+        cout << "           --table=TABLE_FILE  use a table written by build_table" << endl;
+        cout << "           --verify  check the whole table file against its checksum first" << endl;
+        cout << "           --threads=N  worker threads of the hdastar and batch runs (default: one per core)" << endl;
 		exit(0);
 	}
     
@@ -638,7 +542,23 @@ int main( int argc, char* argv[] ){
 
 	
 try{
-    if( (typeOfRun == "single_run") || (typeOfRun == "animate_run") ){
+    if (!g_table_path.empty() && typeOfRun != "build_table") {
+        string error;
+        if (!load_table(g_table_path, error, g_verify_table)) cout << "--table ignored: " << error << endl;
+    }
+
+    if (typeOfRun == "build_table") {
+        if (argc < 5 || (algorithmSelected != "distance_table" && algorithmSelected != "pdb_555")) {
+            cout << "SYNTAX: search.exe build_table <distance_table or pdb_555> \"GOAL STATE\" TABLE_FILE" << endl;
+            exit(0);
+        }
+        string error;
+        bool written = (algorithmSelected == "pdb_555") ? build_pattern_database(string(argv[3]), string(argv[4]), error)
+                                                        : build_distance_table(string(argv[3]), string(argv[4]), error);
+        if (written) cout << "wrote " << argv[4] << endl;
+        else cout << error << endl;
+
+    } else if( (typeOfRun == "single_run") || (typeOfRun == "animate_run") ){
         if (argc < 5) {
             cout << "<< SEARCH ALGORITHMS >>" << endl;
             cout << "please include missing parameters." << endl;
@@ -661,23 +581,151 @@ try{
         else if (algorithmSelected == "astar_explist_manhattan") {
             cout << setw(31) << std::left << "3) astar_explist_manhattan";
         }
+        else if (algorithmSelected == "idastar_manhattan") {
+            cout << setw(31) << std::left << "4) idastar_manhattan";
+        }
+        else if (algorithmSelected == "idastar_misplacedtiles") {
+            cout << setw(31) << std::left << "5) idastar_misplacedtiles";
+        }
+        else if (algorithmSelected == "distance_table") {
+            cout << setw(31) << std::left << "6) distance_table";
+        }
+        else if (algorithmSelected == "astar_explist_pdb") {
+            cout << setw(31) << std::left << "7) astar_explist_pdb";
+        }
+        else if (algorithmSelected == "idastar_pdb") {
+            cout << setw(31) << std::left << "8) idastar_pdb";
+        }
+        else if (algorithmSelected == "astar_explist_linearconflict") {
+            cout << setw(31) << std::left << "9) astar_explist_linearconflict";
+        }
+        else if (algorithmSelected == "idastar_linearconflict") {
+            cout << setw(31) << std::left << "10) idastar_linearconflict";
+        }
+        else if (algorithmSelected == "astar_explist_walkingdistance") {
+            cout << setw(31) << std::left << "11) astar_explist_walkingdistance";
+        }
+        else if (algorithmSelected == "idastar_walkingdistance") {
+            cout << setw(31) << std::left << "12) idastar_walkingdistance";
+        }
+        else if (algorithmSelected == "hdastar_manhattan") {
+            cout << setw(31) << std::left << "13) hdastar_manhattan";
+        }
+        else if (algorithmSelected == "hdastar_linearconflict") {
+            cout << setw(31) << std::left << "14) hdastar_linearconflict";
+        }
+        else if (algorithmSelected == "hdastar_pdb") {
+            cout << setw(31) << std::left << "15) hdastar_pdb";
+        }
+        else if (algorithmSelected == "bidirectional_uc") {
+            cout << setw(31) << std::left << "16) bidirectional_uc";
+        }
+        else if (algorithmSelected == "mm_manhattan") {
+            cout << setw(31) << std::left << "17) mm_manhattan";
+        }
+        else if (algorithmSelected == "mm_linearconflict") {
+            cout << setw(31) << std::left << "18) mm_linearconflict";
+        }
+        else if (algorithmSelected == "mm_pdb") {
+            cout << setw(31) << std::left << "19) mm_pdb";
+        }
         //---
 
         if (algorithmSelected == "uc_explist") {
 
-            path = uc_explist(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
+            path = uc_explist(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, g_open_list);
 
         }
        
         else if (algorithmSelected == "astar_explist_misplacedtiles") {
 
-            path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, misplacedTiles);
+            path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, misplacedTiles, g_open_list);
 
         }
         else if (algorithmSelected == "astar_explist_manhattan") {
 
             
-            path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap,numOfLocalLoopsAvoided ,numOfAttemptedNodeReExpansions, manhattanDistance);
+            path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap,numOfLocalLoopsAvoided ,numOfAttemptedNodeReExpansions, manhattanDistance, g_open_list);
+
+        }
+        else if (algorithmSelected == "idastar_manhattan") {
+
+            path = ida_star(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, manhattanDistance);
+
+        }
+        else if (algorithmSelected == "idastar_misplacedtiles") {
+
+            path = ida_star(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, misplacedTiles);
+
+        }
+        else if (algorithmSelected == "distance_table") {
+
+            path = distance_table(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
+
+        }
+        else if (algorithmSelected == "astar_explist_pdb") {
+
+            path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, patternDatabase, g_open_list);
+
+        }
+        else if (algorithmSelected == "idastar_pdb") {
+
+            path = ida_star(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, patternDatabase);
+
+        }
+        else if (algorithmSelected == "astar_explist_linearconflict") {
+
+            path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, linearConflict, g_open_list);
+
+        }
+        else if (algorithmSelected == "idastar_linearconflict") {
+
+            path = ida_star(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, linearConflict);
+
+        }
+        else if (algorithmSelected == "astar_explist_walkingdistance") {
+
+            path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, walkingDistance, g_open_list);
+
+        }
+        else if (algorithmSelected == "idastar_walkingdistance") {
+
+            path = ida_star(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, walkingDistance);
+
+        }
+        else if (algorithmSelected == "hdastar_manhattan") {
+
+            path = hda_star(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, manhattanDistance, g_threads);
+
+        }
+        else if (algorithmSelected == "hdastar_linearconflict") {
+
+            path = hda_star(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, linearConflict, g_threads);
+
+        }
+        else if (algorithmSelected == "hdastar_pdb") {
+
+            path = hda_star(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, patternDatabase, g_threads);
+
+        }
+        else if (algorithmSelected == "bidirectional_uc") {
+
+            path = bidirectional_uc(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, g_open_list);
+
+        }
+        else if (algorithmSelected == "mm_manhattan") {
+
+            path = mm_search(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, manhattanDistance, g_open_list);
+
+        }
+        else if (algorithmSelected == "mm_linearconflict") {
+
+            path = mm_search(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, linearConflict, g_open_list);
+
+        }
+        else if (algorithmSelected == "mm_pdb") {
+
+            path = mm_search(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, patternDatabase, g_open_list);
 
         }
 
@@ -695,6 +743,22 @@ try{
 
             run_astar_manhattan_experiments();
 
+        }else if (algorithmSelected == "idastar_manhattan") {
+
+            run_idastar_manhattan_experiments();
+
+        }else if (algorithmSelected == "distance_table") {
+
+            run_distance_table_experiments();
+
+        }else if (algorithmSelected == "bidirectional_uc") {
+
+            run_bidirectional_uc_experiments();
+
+        }else if (algorithmSelected == "mm_manhattan") {
+
+            run_mm_manhattan_experiments();
+
         }else if (algorithmSelected == "all") {
             using std::chrono::system_clock;
             system_clock::time_point start;             
@@ -725,7 +789,8 @@ catch(exception &e){
 
     }
     else if ((typeOfRun == "single_run") || (typeOfRun == "animate_run") ){
-        if (pathLength == 0) cout << "\n\n*---- NO SOLUTION found. (Q is empty!) ----*" << endl;
+        if (pathLength == UNSOLVABLE) cout << "\n\n*---- UNSOLVABLE: start and goal are in different parity classes. ----*" << endl;
+        else if (pathLength == 0) cout << "\n\n*---- NO SOLUTION found. (Q is empty!) ----*" << endl;
 
         cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << endl << endl << "Initial State:" << std::fixed << ' ' << setw(12) << initialState << endl;
         cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << "Goal State:" << std::fixed << ' ' << setw(12) << goalState << endl;
@@ -743,7 +808,8 @@ catch(exception &e){
     }  
     
     if(typeOfRun == "animate_run"){
-        if (pathLength == 0) cout << "\n\n*---- NO SOLUTION found. (Q is empty!) ----*" << endl;
+        if (pathLength == UNSOLVABLE) cout << "\n\n*---- UNSOLVABLE: start and goal are in different parity classes. ----*" << endl;
+        else if (pathLength == 0) cout << "\n\n*---- NO SOLUTION found. (Q is empty!) ----*" << endl;
 
         if (path != "") {            
             AnimateSolution(initialState, goalState, path);            
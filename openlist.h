@@ -0,0 +1,206 @@
+#ifndef __OPENLIST_H__
+#define __OPENLIST_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+
+//////////////////////////////////////////////////////
+// OPEN lists for the best-first engines.
+//
+// All hold Node pointers with int members f and g and offer
+//     push(nd), pop(), empty(), size(), decrease(nd, g, f), clear()
+// so an engine can be instantiated with any of them.  clear() empties
+// the list but keeps its memory for the next search.
+//
+// decrease() lowers the g and f of a node still on the list.  Only the
+// indexed heap can do that in place; the others return false and leave
+// the node alone, and the engine falls back to marking it dead and
+// pushing a fresh copy.
+//////////////////////////////////////////////////////
+
+
+//////////////////////////////////////////////////////
+// Binary heap ordered by Cmp (CmpUC or CmpAstar)
+//////////////////////////////////////////////////////
+template <class Node, class Cmp>
+class HeapOpenList
+{
+    std::vector<Node*> heap;
+
+public:
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+
+    void clear() { heap.clear(); }
+
+    void push(Node *nd)
+    {
+        heap.push_back(nd);
+        std::push_heap(heap.begin(), heap.end(), Cmp());
+    }
+
+    Node *pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), Cmp());
+        Node *nd = heap.back();
+        heap.pop_back();
+        return nd;
+    }
+
+    bool decrease(Node *, int, int) { return false; }
+};
+
+
+//////////////////////////////////////////////////////
+// Bucket queue for small integer costs.
+//
+// bucket[f][g] is a LIFO stack; pop() takes the lowest f and, within it,
+// the highest g, the same order as CmpAstar.  For UC f == g, which gives
+// CmpUC's order.  The costs of the sliding-tile puzzles are bounded
+// (g <= 31 for the 8-puzzle, f around 80 for the 15-puzzle), so finding
+// the next bucket is a short scan and push/pop are O(1) in the size of
+// the list, with no sifting through memory.
+//////////////////////////////////////////////////////
+template <class Node, class Cmp>
+class BucketOpenList
+{
+    std::vector<std::vector<std::vector<Node*>>> bucket; // [f][g]
+    std::vector<size_t> countF;                         // nodes held per f
+    size_t count = 0;
+    int minF = 0;
+
+public:
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void clear()
+    {
+        for (auto &byG : bucket)
+            for (auto &stack : byG) stack.clear();
+        std::fill(countF.begin(), countF.end(), 0);
+        count = 0;
+        minF = 0;
+    }
+
+    void push(Node *nd)
+    {
+        if (nd->f >= (int)bucket.size()) {
+            bucket.resize(nd->f + 1);
+            countF.resize(nd->f + 1, 0);
+        }
+        std::vector<std::vector<Node*>> &byG = bucket[nd->f];
+        if (nd->g >= (int)byG.size()) byG.resize(nd->g + 1);
+
+        byG[nd->g].push_back(nd);
+        countF[nd->f]++;
+        if (count == 0 || nd->f < minF) minF = nd->f;
+        count++;
+    }
+
+    Node *pop() // list must not be empty
+    {
+        while (countF[minF] == 0) minF++;
+
+        std::vector<std::vector<Node*>> &byG = bucket[minF];
+        int g = (int)byG.size() - 1;
+        while (byG[g].empty()) g--;
+
+        Node *nd = byG[g].back();
+        byG[g].pop_back();
+        countF[minF]--;
+        count--;
+        return nd;
+    }
+
+    bool decrease(Node *, int, int) { return false; }
+};
+
+
+//////////////////////////////////////////////////////
+// Binary heap with decrease-key.
+//
+// Every node remembers its slot in Node::heapIndex, so a cheaper path to
+// a state already on the list sifts that node up in place instead of
+// leaving a dead duplicate behind.  The list then never holds more than
+// one entry per open state.
+//////////////////////////////////////////////////////
+template <class Node, class Cmp>
+class IndexedHeapOpenList
+{
+    std::vector<Node*> heap;
+
+    void place(Node *nd, size_t i)
+    {
+        heap[i] = nd;
+        nd->heapIndex = (int)i;
+    }
+
+    void siftUp(size_t i)
+    {
+        Node *nd = heap[i];
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!Cmp()(heap[parent], nd)) break;
+            place(heap[parent], i);
+            i = parent;
+        }
+        place(nd, i);
+    }
+
+    void siftDown(size_t i)
+    {
+        Node *nd = heap[i];
+        const size_t n = heap.size();
+        for (;;) {
+            size_t child = 2 * i + 1;
+            if (child >= n) break;
+            if (child + 1 < n && Cmp()(heap[child], heap[child + 1])) child++;
+            if (!Cmp()(nd, heap[child])) break;
+            place(heap[child], i);
+            i = child;
+        }
+        place(nd, i);
+    }
+
+public:
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+
+    void clear() { heap.clear(); }
+
+    void push(Node *nd)
+    {
+        heap.push_back(nd);
+        siftUp(heap.size() - 1);
+    }
+
+    Node *pop()
+    {
+        Node *top = heap.front();
+        Node *last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            siftDown(0);
+        }
+        top->heapIndex = -1;
+        return top;
+    }
+
+    // nd must be on the list, g and f no larger than its current values
+    bool decrease(Node *nd, int g, int f)
+    {
+        nd->g = g;
+        nd->f = f;
+        siftUp((size_t)nd->heapIndex);
+        return true;
+    }
+};
+
+
+#endif
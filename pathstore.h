@@ -0,0 +1,61 @@
+#ifndef __PATHSTORE_H__
+#define __PATHSTORE_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "state.h"
+
+
+//////////////////////////////////////////////////////
+// Predecessor store for the best-first engines.
+//
+// Every generated node gets one 32-bit entry, (parent id << 2) | move,
+// instead of a copy of its whole path.  Entry 0 is the start node.  The
+// move string is only spelled out, by walking the parents back to the
+// start, once the goal has been reached.  Ids have 30 bits, so a search
+// that generates 2^30 nodes stops with length_error.
+//////////////////////////////////////////////////////
+class PathStore
+{
+    static const size_t MAX_NODES = size_t(1) << 30;
+
+    std::vector<uint32_t> entry;
+
+public:
+
+    // empties the store and returns the id of the start node
+    uint32_t reset()
+    {
+        entry.assign(1, 0);
+        return 0;
+    }
+
+    uint32_t add(uint32_t parent, moveDirection d)
+    {
+        if (entry.size() == MAX_NODES) throw std::length_error("path store is full (2^30 nodes)");
+        entry.push_back((parent << 2) | uint32_t(d));
+        return uint32_t(entry.size() - 1);
+    }
+
+    // move that led to node id, -1 for the start
+    int lastMove(uint32_t id) const
+    {
+        return id == 0 ? -1 : int(entry[id] & 3);
+    }
+
+    std::string path(uint32_t id) const
+    {
+        std::string s;
+        for (; id != 0; id = entry[id] >> 2) s.push_back(MOVE_CHAR[entry[id] & 3]);
+        std::reverse(s.begin(), s.end());
+        return s;
+    }
+
+    size_t size() const { return entry.size(); }
+};
+
+
+#endif
@@ -0,0 +1,293 @@
+#include "pdb.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+// tile groups by name, see pdb.h; 0 marks the blank
+const uint8_t DEFAULT_PARTITION[16] = {0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 3, 3, 2, 3, 3, 3};
+
+const int TRANSPOSE[16] = {0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15};
+
+const uint8_t UNREACHED = 0xFF;
+
+PatternDatabase15 sharedPdb; // read-only once loaded, shared by every thread
+
+// rank of 5 distinct squares of 16 among all ordered placements
+inline uint32_t rankSquares(const int *sq){
+    uint32_t r = 0;
+    unsigned used = 0;
+    for(int i = 0; i < 5; i++){
+        r = r * uint32_t(16 - i) + uint32_t(sq[i] - __builtin_popcount(used & ((1u << sq[i]) - 1)));
+        used |= 1u << sq[i];
+    }
+    return r;
+}
+
+// BFS state: the squares of the group's five tiles, 4 bits each from
+// bit 20 down, and the blank square in bits 0-3
+inline int squareOf(uint32_t code, int i){
+    return int((code >> (4 * (5 - i))) & 15);
+}
+
+}
+
+
+PatternDatabase15::PatternDatabase15() : goalBoard(), mirrored(false), cost(nullptr) {
+    for(int t = 0; t < 16; t++){
+        group[t] = -1;
+        mirrorTile[t] = t;
+    }
+}
+
+
+bool PatternDatabase15::setGoal(const Board15 &goal, const uint8_t *partition){
+    int filled[GROUPS] = {0, 0, 0};
+    for(int t = 1; t < 16; t++){
+        const int g = int(partition[t]) - 1;
+        if(g < 0 || g >= GROUPS || filled[g] == GROUP_SIZE) return false;
+        group[t] = g;
+        groupTiles[g][filled[g]++] = t;
+    }
+    group[0] = -1;
+
+    goalBoard = goal;
+
+    int goalPos[16];
+    for(int i = 0; i < 16; i++) goalPos[goal.tile(i)] = i;
+
+    mirrored = (TRANSPOSE[goal.blank()] == goal.blank());
+    for(int t = 0; t < 16; t++) mirrorTile[t] = goal.tile(TRANSPOSE[goalPos[t]]);
+    return true;
+}
+
+
+void PatternDatabase15::buildGroup(int g, uint8_t *out) const {
+    typedef Geometry<4, 4> Geo;
+
+    std::vector<uint8_t> dist(size_t(1) << 24, UNREACHED);
+    std::vector<uint32_t> current, next;
+
+    uint32_t start = 0;
+    for(int i = 0; i < GROUP_SIZE; i++){
+        for(int sq = 0; sq < 16; sq++)
+            if(goalBoard.tile(sq) == groupTiles[g][i]) start = (start << 4) | uint32_t(sq);
+    }
+    start = (start << 4) | uint32_t(goalBoard.blank());
+
+    dist[start] = 0;
+    current.push_back(start);
+
+    // level d: current holds codes at cost d and grows while free moves
+    // reach new codes; moves of the group's tiles feed the next level
+    for(int d = 0; !current.empty(); d++){
+        next.clear();
+        for(size_t k = 0; k < current.size(); k++){
+            const uint32_t code = current[k];
+            if(dist[code] != d) continue; // reached more cheaply since queued
+
+            const int blank = int(code & 15);
+            for(int m = dirUp; m <= dirLeft; m++){
+                const int to = Geo::neighbour(blank, moveDirection(m));
+                if(to < 0) continue;
+
+                int moved = -1;
+                for(int i = 0; i < GROUP_SIZE; i++)
+                    if(squareOf(code, i) == to) moved = i;
+
+                if(moved < 0){
+                    const uint32_t c = (code & ~uint32_t(15)) | uint32_t(to);
+                    if(dist[c] > d){
+                        dist[c] = uint8_t(d);
+                        current.push_back(c);
+                    }
+                } else {
+                    const int shift = 4 * (5 - moved);
+                    uint32_t c = (code & ~(uint32_t(15) << shift)) | (uint32_t(blank) << shift);
+                    c = (c & ~uint32_t(15)) | uint32_t(to);
+                    if(dist[c] > d + 1){
+                        dist[c] = uint8_t(d + 1);
+                        next.push_back(c);
+                    }
+                }
+            }
+        }
+        current.swap(next);
+    }
+
+    // keep the cheapest blank square per placement of the group
+    memset(out, UNREACHED, ENTRIES);
+    for(uint32_t code = 0; code < dist.size(); code++){
+        if(dist[code] == UNREACHED) continue;
+        int sq[GROUP_SIZE];
+        for(int i = 0; i < GROUP_SIZE; i++) sq[i] = squareOf(code, i);
+        const uint32_t r = rankSquares(sq);
+        if(dist[code] < out[r]) out[r] = dist[code];
+    }
+}
+
+
+std::shared_ptr<const PatternDatabase15> PatternDatabase15::forGoal(const Board15 &goal){
+    // the loaded database lives as long as the program: owned by no one
+    if(sharedPdb.built() && sharedPdb.goal() == goal)
+        return std::shared_ptr<const PatternDatabase15>(std::shared_ptr<const PatternDatabase15>(), &sharedPdb);
+
+    // the databases of the last few goals, most recently used last.  A
+    // canonical goal is fixed by its blank square, so this covers the
+    // goals of most runs; one pushed out lives on with its owners.
+    static const size_t KEPT = 4;
+    static std::mutex lock;
+    static std::vector<std::shared_ptr<const PatternDatabase15>> recent;
+
+    // moves goal's database, if kept, to the back
+    auto find = [&goal]() -> std::shared_ptr<const PatternDatabase15> {
+        for(size_t i = 0; i < recent.size(); i++){
+            if(recent[i]->goal() != goal) continue;
+            std::rotate(recent.begin() + i, recent.begin() + i + 1, recent.end());
+            return recent.back();
+        }
+        return std::shared_ptr<const PatternDatabase15>();
+    };
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::shared_ptr<const PatternDatabase15> pdb = find();
+        if(pdb) return pdb;
+    }
+
+    // built unlocked, so threads with other goals are not held up
+    std::shared_ptr<PatternDatabase15> fresh = std::make_shared<PatternDatabase15>();
+    fresh->build(goal);
+
+    std::lock_guard<std::mutex> guard(lock);
+    std::shared_ptr<const PatternDatabase15> pdb = find();
+    if(pdb) return pdb;  // another thread finished first
+    if(recent.size() == KEPT) recent.erase(recent.begin());
+    recent.push_back(fresh);
+    return fresh;
+}
+
+
+bool PatternDatabase15::loadShared(const std::string &path, std::string &error){
+    return sharedPdb.load(path, error);
+}
+
+
+void PatternDatabase15::build(const Board15 &goal){
+    file.close();
+    setGoal(goal, DEFAULT_PARTITION);
+
+    memory.assign(size_t(GROUPS) * ENTRIES, UNREACHED);
+    for(int g = 0; g < GROUPS; g++) buildGroup(g, memory.data() + size_t(g) * ENTRIES);
+    cost = memory.data();
+}
+
+
+bool PatternDatabase15::save(const std::string &path, std::string &error) const {
+    if(!built()){
+        error = "no pattern database to save";
+        return false;
+    }
+    TableHeader h;
+    memset(&h, 0, sizeof(h));
+    h.kind = patternDatabaseFile;
+    h.rows = 4;
+    h.cols = 4;
+    for(int i = 0; i < 16; i++) h.goal[i] = uint8_t(goalBoard.tile(i));
+    for(int t = 1; t < 16; t++) h.partition[t] = uint8_t(group[t] + 1);
+
+    return writeTableFile(path, h, cost, size_t(GROUPS) * ENTRIES, error);
+}
+
+
+bool PatternDatabase15::load(const std::string &path, std::string &error){
+    if(!file.open(path, error)) return false;
+
+    const TableHeader &h = file.header();
+    Board15 goal;
+    for(int i = 0; i < 16; i++) goal.set(i, h.goal[i]);
+
+    if(h.kind != patternDatabaseFile || h.rows != 4 || h.cols != 4 || h.entries != uint64_t(GROUPS) * ENTRIES){
+        error = path + " is not a 15-puzzle pattern database";
+    }
+    else if(!setGoal(goal, h.partition)){
+        error = path + " has a tile partition other than 5-5-5";
+    }
+    else {
+        memory.clear();
+        memory.shrink_to_fit();
+        cost = file.data();
+        return true;
+    }
+    file.close();
+    cost = nullptr;
+    return false;
+}
+
+
+int PatternDatabase15::groupCost(int g, const int *posOf) const {
+    int sq[GROUP_SIZE];
+    for(int i = 0; i < GROUP_SIZE; i++) sq[i] = posOf[groupTiles[g][i]];
+    return cost[size_t(g) * ENTRIES + rankSquares(sq)];
+}
+
+
+int PatternDatabase15::sum(const int *posOf) const {
+    int h = 0;
+    for(int g = 0; g < GROUPS; g++) h += groupCost(g, posOf);
+    return h;
+}
+
+
+int PatternDatabase15::evaluate(const int *posOf) const {
+    const int h = sum(posOf);
+    if(!mirrored) return h;
+
+    int mirrorPos[16];
+    for(int t = 1; t < 16; t++) mirrorPos[mirrorTile[t]] = TRANSPOSE[posOf[t]];
+    const int hm = sum(mirrorPos);
+    return hm > h ? hm : h;
+}
+
+
+int PatternDatabase15::evaluate(const Board15 &b) const {
+    int posOf[16];
+    for(int i = 0; i < 16; i++) posOf[b.tile(i)] = i;
+    return evaluate(posOf);
+}
+
+
+void PatternCost::reset(const PatternDatabase15 &db, const int *squares){
+    pdb = &db;
+    total = mirrorTotal = 0;
+    for(int t = 1; t < 16; t++){
+        posOf[t] = squares[t];
+        mirrorPos[db.mirrorTile[t]] = TRANSPOSE[squares[t]];
+    }
+    for(int g = 0; g < PatternDatabase15::GROUPS; g++){
+        part[g] = db.groupCost(g, posOf);
+        total += part[g];
+        mirrorPart[g] = db.mirrored ? db.groupCost(g, mirrorPos) : 0;
+        mirrorTotal += mirrorPart[g];
+    }
+}
+
+
+void PatternCost::moveTile(int t, int to){
+    const int g = pdb->group[t];
+    posOf[t] = to;
+    const int c = pdb->groupCost(g, posOf);
+    total += c - part[g];
+    part[g] = c;
+
+    if(!pdb->mirrored) return;
+
+    const int mt = pdb->mirrorTile[t];
+    const int mg = pdb->group[mt];
+    mirrorPos[mt] = TRANSPOSE[to];
+    const int mc = pdb->groupCost(mg, mirrorPos);
+    mirrorTotal += mc - mirrorPart[mg];
+    mirrorPart[mg] = mc;
+}
@@ -0,0 +1,112 @@
+#ifndef __PDB_H__
+#define __PDB_H__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "state.h"
+#include "tablefile.h"
+
+
+typedef PackedBoard<4, 4> Board15;
+
+//////////////////////////////////////////////////////
+// Additive pattern databases for the 15-puzzle (5-5-5 partition).
+//
+// The numbered tiles are split into three groups of five.  For each group
+// a 0-1 breadth-first search backward from the goal runs over abstract
+// boards on which only the group's tiles and the blank are told apart:
+// moving one of the group's tiles costs 1, moving any other tile is free.
+// The least cost over all blank squares is stored per placement of the
+// group, indexed by the rank of its five squares (16*15*14*13*12 entries
+// of one byte).  Every real move slides one tile of one group, so the
+// three costs never count the same move and their sum is admissible.
+//
+// When the goal's blank lies on the main diagonal, mirroring a board
+// across the diagonal (and renaming its tiles) gives a board of the same
+// puzzle with the same goal and the same distance, so the tables give a
+// second estimate; evaluate() returns the larger of the two.
+//
+// Tiles are grouped by name, {1,2,5,6,9} {3,4,7,8,12} {10,11,13,14,15},
+// compact regions of the canonical goals (see GoalRelabeling).
+//////////////////////////////////////////////////////
+class PatternDatabase15
+{
+public:
+
+    static const int GROUPS = 3;
+    static const int GROUP_SIZE = 5;
+    static const uint32_t ENTRIES = 524160; // per group
+
+private:
+
+    Board15 goalBoard;
+    int group[16];                      // group of each tile, -1 for the blank
+    int groupTiles[GROUPS][GROUP_SIZE];
+    bool mirrored;                      // goal's blank on the main diagonal
+    int mirrorTile[16];                 // name of each tile on the mirrored board
+
+    const uint8_t *cost;                // [group * ENTRIES + rank], into memory or file
+    std::vector<uint8_t> memory;        // tables when built here
+    MappedTable file;                   // tables when loaded
+
+    bool setGoal(const Board15 &goal, const uint8_t *partition);
+    void buildGroup(int g, uint8_t *out) const;
+    int groupCost(int g, const int *posOf) const;
+    int sum(const int *posOf) const;
+
+    friend class PatternCost;
+
+public:
+
+    PatternDatabase15();
+
+    void build(const Board15 &goal);
+
+    bool save(const std::string &path, std::string &error) const;
+    bool load(const std::string &path, std::string &error);
+
+    // the database for a goal: the one read by loadShared() when its goal
+    // matches, else one built on first use (a few seconds) and shared by
+    // every thread.  The databases of the last four goals asked for are
+    // kept after their last owner lets go.
+    static std::shared_ptr<const PatternDatabase15> forGoal(const Board15 &goal);
+    static bool loadShared(const std::string &path, std::string &error);
+
+    bool built() const { return cost != nullptr; }
+    Board15 goal() const { return goalBoard; }
+
+    // posOf[t] is the square of tile t, for t = 1 .. 15
+    int evaluate(const int *posOf) const;
+    int evaluate(const Board15 &b) const;
+};
+
+
+//////////////////////////////////////////////////////
+// Pattern database cost of one board, kept up to date move by move.
+//
+// A move changes the placement of one group on the board and of one group
+// on its mirror image, so only those two entries are looked up again
+// instead of all six.
+//////////////////////////////////////////////////////
+class PatternCost
+{
+    const PatternDatabase15 *pdb = nullptr;
+    int posOf[16], mirrorPos[16];
+    int part[PatternDatabase15::GROUPS], mirrorPart[PatternDatabase15::GROUPS];
+    int total = 0, mirrorTotal = 0;
+
+public:
+
+    // posOf[t] is the square of tile t, for t = 1 .. 15
+    void reset(const PatternDatabase15 &db, const int *squares);
+
+    // tile t now stands on square to
+    void moveTile(int t, int to);
+
+    int value() const { return mirrorTotal > total ? mirrorTotal : total; }
+};
+
+
+#endif
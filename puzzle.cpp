@@ -1,20 +1,29 @@
 #include "puzzle.h"
 #include  <cmath>
 #include  <assert.h>
+#include  <stdexcept>
 
 using namespace std;
 
 //////////////////////////////////////////////////////////////
 //constructor
 //////////////////////////////////////////////////////////////
-Puzzle::Puzzle(const Puzzle &p) : path(p.path){
+template<int Rows, int Cols>
+Puzzle<Rows, Cols>::Puzzle(const Puzzle &p){
 	
-	for(int i=0; i < 3; i++){
-		for(int j=0; j < 3; j++){	
+	//room for the moves still to come, so applyMove() does not allocate
+	path.reserve(PATH_ROOM);
+	path = p.path;
+	
+	for(int i=0; i < Rows; i++){
+		for(int j=0; j < Cols; j++){	
 		    board[i][j] = p.board[i][j];
 		    goalBoard[i][j] = p.goalBoard[i][j];
 		}
 	}	
+	for(int t=0; t < Rows * Cols; t++) goalPos[t] = p.goalPos[t];
+	hFunction = p.hFunction;
+	hTracked = p.hTracked;
 	
 	x0 = p.x0;
 	y0 = p.y0;
@@ -22,7 +31,7 @@ Puzzle::Puzzle(const Puzzle &p) : path(p.path){
 	pathLength = p.pathLength;
 	hCost = p.hCost;
 	fCost = p.fCost;	
-	strBoard = toString(); //uses the board contents to generate the string equivalent
+	state = p.state;
 	depth = p.depth; //useful for depth-limited search only
 	
 }
@@ -31,14 +40,15 @@ Puzzle::Puzzle(const Puzzle &p) : path(p.path){
 //constructor
 //inputs:  initial state, goal state
 //////////////////////////////////////////////////////////////
-Puzzle::Puzzle(string const elements, string const goal){
+template<int Rows, int Cols>
+Puzzle<Rows, Cols>::Puzzle(string const elements, string const goal){
 	
 	int n;
 	
 	n = 0;
-	for(int i=0; i < 3; i++){
-		for(int j=0; j < 3; j++){	
-		    board[i][j] = elements[n] - '0';
+	for(int i=0; i < Rows; i++){
+		for(int j=0; j < Cols; j++){	
+		    board[i][j] = tileValue(elements[n]);
 		    if(board[i][j] == 0){
 			    x0 = j;
 			    y0 = i;
@@ -49,70 +59,80 @@ Puzzle::Puzzle(string const elements, string const goal){
 		
 	///////////////////////
 	n = 0;
-	for(int i=0; i < 3; i++){
-		for(int j=0; j < 3; j++){	
-		    goalBoard[i][j] = goal[n] - '0';
+	for(int i=0; i < Rows; i++){
+		for(int j=0; j < Cols; j++){	
+		    goalBoard[i][j] = tileValue(goal[n]);
+		    goalPos[goalBoard[i][j]] = n;
 		    n++;
 		} 
 	}		
 	///////////////////////	
+	path.reserve(PATH_ROOM);
 	path = "";
 	pathLength=0;
 	hCost = 0;
 	fCost = 0;
 	depth = 0;
-	strBoard = toString();	
+	hFunction = manhattanDistance;
+	hTracked = false;
+	state = Board::fromString(elements);
 }
 
 
-void Puzzle::setDepth(int d){
+template<int Rows, int Cols>
+void Puzzle<Rows, Cols>::setDepth(int d){
 	depth = d;
 }
 
-int Puzzle::getDepth(){
+template<int Rows, int Cols>
+int Puzzle<Rows, Cols>::getDepth(){
 	return depth;
 }
 
-void Puzzle::updateHCost(heuristicFunction hFunction){
+//from now on applyMove() and undoMove() keep hCost up to date
+template<int Rows, int Cols>
+void Puzzle<Rows, Cols>::updateHCost(heuristicFunction hFunction){
 	hCost = h(hFunction);
+	this->hFunction = hFunction;
+	hTracked = true;
 }
 
-void Puzzle::updateFCost(){
-	//fCost = ?
+template<int Rows, int Cols>
+void Puzzle<Rows, Cols>::updateFCost(){
+	fCost = pathLength + hCost;
 }
 
-int Puzzle::getFCost(){
+template<int Rows, int Cols>
+int Puzzle<Rows, Cols>::getFCost(){
 	return fCost;
 }
 
-int Puzzle::getHCost(){
+template<int Rows, int Cols>
+int Puzzle<Rows, Cols>::getHCost(){
 	return hCost;
 }
 
-int Puzzle::getGCost(){
+template<int Rows, int Cols>
+int Puzzle<Rows, Cols>::getGCost(){
 	return pathLength;
 }
 
-//Heuristic function implementation
-int Puzzle::h(heuristicFunction hFunction){
+//Heuristic function implementation: the sums over tiles only, the search
+//engines compute the others (see heuristic.h)
+template<int Rows, int Cols>
+int Puzzle<Rows, Cols>::h(heuristicFunction hFunction){
+	
+	if(hFunction != misplacedTiles && hFunction != manhattanDistance)
+		throw invalid_argument("Puzzle::h computes misplacedTiles and manhattanDistance only");
 	
-	int sum=0;
 	int h=0;
-	int numOfMisplacedTiles=0;
-	
-	switch(hFunction){
-		case misplacedTiles:			      
-				//place your implementation here	
-                h = numOfMisplacedTiles; 					
-		        break;
-		         
-		case manhattanDistance:
-		        //place your implementation here
-		        
-		        h = sum; 					
-		        break;         
-		           
-	};
+	
+	for(int i=0; i < Rows; i++){
+		for(int j=0; j < Cols; j++){	
+		    int t = board[i][j];
+		    if(t != 0) h += tileCost(hFunction, i * Cols + j, goalPos[t], Cols);
+		}
+	}
 	
 	return h;
 	
@@ -120,14 +140,15 @@ int Puzzle::h(heuristicFunction hFunction){
 
 
 //converts board state into its string representation
-string Puzzle::toString(){
+template<int Rows, int Cols>
+string Puzzle<Rows, Cols>::toString(){
   int n;
   string stringPath;
   
   n=0;
-  for(int i=0; i < 3; i++){
-		for(int j=0; j < 3; j++){			    
-		    stringPath.insert(stringPath.end(), board[i][j] + '0');
+  for(int i=0; i < Rows; i++){
+		for(int j=0; j < Cols; j++){			    
+		    stringPath.insert(stringPath.end(), tileChar(board[i][j]));
 		    n++;
 		} 
   }
@@ -139,180 +160,179 @@ string Puzzle::toString(){
 
 
 
-bool Puzzle::goalMatch(){
+template<int Rows, int Cols>
+bool Puzzle<Rows, Cols>::goalMatch(){
 	bool result=false;
     
     //this is incomplete...
 	return result;
 }
 
-bool Puzzle::canMoveLeft(){
+template<int Rows, int Cols>
+bool Puzzle<Rows, Cols>::canMoveLeft(){
    return (x0 > 0);
 	
 }
 
-const string Puzzle::getPath(){
+template<int Rows, int Cols>
+const string Puzzle<Rows, Cols>::getPath(){
 	return path;
 }
 
-bool Puzzle::canMoveRight(){
+template<int Rows, int Cols>
+bool Puzzle<Rows, Cols>::canMoveRight(){
 
-   return (x0 < 2);
+   return (x0 < Cols - 1);
 	
 }
 
 
-bool Puzzle::canMoveUp(){
+template<int Rows, int Cols>
+bool Puzzle<Rows, Cols>::canMoveUp(){
 
    return (y0 > 0);
 	
 }
 
-bool Puzzle::canMoveDown(){
+template<int Rows, int Cols>
+bool Puzzle<Rows, Cols>::canMoveDown(){
 
-   return (y0 < 2);
+   return (y0 < Rows - 1);
 	
 }
 
 ///////////////////////////////////////////////
 //these functions will be useful for Progressive Deepening Search 
+//a move is allowed only while the depth bound has not been reached
 
-bool Puzzle::canMoveLeft(int maxDepth){
-  	
-  	bool m=false;
-  	//put your implementations here
-  	return m; 
+template<int Rows, int Cols>
+bool Puzzle<Rows, Cols>::canMoveLeft(int maxDepth){
+   
+   return (depth < maxDepth) && canMoveLeft();
 }
-bool Puzzle::canMoveRight(int maxDepth){
+template<int Rows, int Cols>
+bool Puzzle<Rows, Cols>::canMoveRight(int maxDepth){
    
-  	bool m=false;
-  	//put your implementations here
-  	return m; 
+   return (depth < maxDepth) && canMoveRight();
 }
 
 
-bool Puzzle::canMoveUp(int maxDepth){
+template<int Rows, int Cols>
+bool Puzzle<Rows, Cols>::canMoveUp(int maxDepth){
    
-  	bool m=false;
-  	//put your implementations here
-  	return m; 
+   return (depth < maxDepth) && canMoveUp();
 }
 
-bool Puzzle::canMoveDown(int maxDepth){
+template<int Rows, int Cols>
+bool Puzzle<Rows, Cols>::canMoveDown(int maxDepth){
    
-  	bool m=false;
-  	//put your implementations here
-  	return m; 
+   return (depth < maxDepth) && canMoveDown();
 }
 
 ///////////////////////////////////////////////
 
-Puzzle *Puzzle::moveLeft(){
-	
-	Puzzle *p = new Puzzle(*this);
-	
-	
-   if(x0 > 0){
-		
-		p->board[y0][x0] = p->board[y0][x0-1];
-		p->board[y0][x0-1] = 0;
-		
-		p->x0--;
-		
-		p->path = path + "L";
-		p->pathLength = pathLength + 1;  
-		p->depth = depth + 1; 
-		
-		
-	}
-	p->strBoard = p->toString();
+//column and row offsets of the tile that slides into the blank, URDL
+static const int DX[4] = { 0, 1, 0, -1};
+static const int DY[4] = {-1, 0, 1,  0};
 
-	return p;
-	
-}
+static const char PATH_CHAR[4] = {'U', 'R', 'D', 'L'};
 
-
-Puzzle *Puzzle::moveRight(){
-	
-   Puzzle *p = new Puzzle(*this);
+template<int Rows, int Cols>
+void Puzzle<Rows, Cols>::applyMove(moveDirection dir){
 	
+	int x = x0 + DX[dir];
+	int y = y0 + DY[dir];
+	int t = board[y][x];
 	
-   if(x0 < 2){
-		
-		p->board[y0][x0] = p->board[y0][x0+1];
-		p->board[y0][x0+1] = 0;
-		
-		p->x0++;
-		
-		p->path = path + "R";
-		p->pathLength = pathLength + 1; 
-     	
-		p->depth = depth + 1;
-		
+	if(hTracked){
+		//only the moved tile changes its share of h
+		hCost += tileCost(hFunction, y0 * Cols + x0, goalPos[t], Cols) - tileCost(hFunction, y * Cols + x, goalPos[t], Cols);
 	}
 	
-	p->strBoard = p->toString();
+	board[y0][x0] = t;
+	board[y][x] = 0;
 	
-	return p;
+	x0 = x;
+	y0 = y;
+	state = state.moved(dir);
+	
+	path.push_back(PATH_CHAR[dir]);
+	pathLength++;
+	depth++;
+	updateFCost();
 	
 }
 
-
-Puzzle *Puzzle::moveUp(){
+template<int Rows, int Cols>
+void Puzzle<Rows, Cols>::undoMove(moveDirection dir){
 	
-   Puzzle *p = new Puzzle(*this);
+	moveDirection back = inverseOf(dir);
+	int x = x0 + DX[back];
+	int y = y0 + DY[back];
+	int t = board[y][x];
 	
+	if(hTracked){
+		hCost += tileCost(hFunction, y0 * Cols + x0, goalPos[t], Cols) - tileCost(hFunction, y * Cols + x, goalPos[t], Cols);
+	}
 	
-   if(y0 > 0){
-		
-		p->board[y0][x0] = p->board[y0-1][x0];
-		p->board[y0-1][x0] = 0;
-		
-		p->y0--;
-		
-		p->path = path + "U";
-		p->pathLength = pathLength + 1;  
+	board[y0][x0] = t;
+	board[y][x] = 0;
 	
-		p->depth = depth + 1;
-		
-	}
-	p->strBoard = p->toString();
+	x0 = x;
+	y0 = y;
+	state = state.moved(back);
 	
-	return p;
+	path.pop_back();
+	pathLength--;
+	depth--;
+	updateFCost();
 	
 }
 
-Puzzle *Puzzle::moveDown(){
+///////////////////////////////////////////////
+
+template<int Rows, int Cols>
+Puzzle<Rows, Cols> *Puzzle<Rows, Cols>::moved(moveDirection dir){
 	
-   Puzzle *p = new Puzzle(*this);
+	Puzzle *p = new Puzzle(*this);
 	
-	
-   if(y0 < 2){
-		
-		p->board[y0][x0] = p->board[y0+1][x0];
-		p->board[y0+1][x0] = 0;
-		
-		p->y0++;
-		
-		p->path = path + "D";
-		p->pathLength = pathLength + 1;  
-		
-		p->depth = depth + 1;
-		
-	}
-	p->strBoard = p->toString();	
+	if(canMove(dir)) p->applyMove(dir);
 	
 	return p;
 	
 }
 
+
+template<int Rows, int Cols>
+Puzzle<Rows, Cols> *Puzzle<Rows, Cols>::moveLeft(){
+	return moved(dirLeft);
+}
+
+
+template<int Rows, int Cols>
+Puzzle<Rows, Cols> *Puzzle<Rows, Cols>::moveRight(){
+	return moved(dirRight);
+}
+
+
+template<int Rows, int Cols>
+Puzzle<Rows, Cols> *Puzzle<Rows, Cols>::moveUp(){
+	return moved(dirUp);
+}
+
+template<int Rows, int Cols>
+Puzzle<Rows, Cols> *Puzzle<Rows, Cols>::moveDown(){
+	return moved(dirDown);
+}
+
 /////////////////////////////////////////////////////
 
 
-void Puzzle::printBoard(){
+template<int Rows, int Cols>
+void Puzzle<Rows, Cols>::printBoard(){
 	cout << "board: "<< endl;
-	for(int i=0; i < 3; i++){
-		for(int j=0; j < 3; j++){	
+	for(int i=0; i < Rows; i++){
+		for(int j=0; j < Cols; j++){	
 		  cout << endl << "board[" << i << "][" << j << "] = " << board[i][j];
 		}
 	}
@@ -320,6 +340,12 @@ void Puzzle::printBoard(){
 	
 }
 
-int Puzzle::getPathLength(){
+template<int Rows, int Cols>
+int Puzzle<Rows, Cols>::getPathLength(){
 	return pathLength;
 }
+
+
+template class Puzzle<3, 3>;
+template class Puzzle<4, 4>;
+template class Puzzle<5, 5>;
@@ -1,31 +1,48 @@
+#ifndef __PUZZLE_H__
+#define __PUZZLE_H__
+
 #include <string>
 #include <iostream>
+#include "heuristic.h"
 
 using namespace std;
 
 
-enum heuristicFunction{misplacedTiles, manhattanDistance};
+//////////////////////////////////////////////////////
+// Rows x Cols sliding-tile puzzle.  Tiles are written '1'..'9', then
+// 'A', 'B', ... for 10 and up; '0' is the blank.  The member functions
+// are instantiated in puzzle.cpp for the 3x3, 4x4 and 5x5 boards.
+//////////////////////////////////////////////////////
+template<int Rows, int Cols>
+class Puzzle{
 
+public:
 
-class Puzzle{
+    typedef PackedBoard<Rows, Cols> Board;
         
 private:
 
+    static const size_t PATH_ROOM = 256; //moves the path holds before it must grow
+
     string path;
     int pathLength;
     int hCost;
     int fCost;
     int depth; //useful for depth-limited search only
         
-    int goalBoard[3][3];
+    int goalBoard[Rows][Cols];
+    signed char goalPos[Rows * Cols]; //goal square of each tile
+    
+    heuristicFunction hFunction; //heuristic kept up to date by the moves,
+    bool hTracked;               //once updateHCost() has been called
     
     int x0, y0; //coordinates of the blank or 0-tile
     
-    int board[3][3];
+    int board[Rows][Cols];
     
 public:
     
-    string strBoard;
+    Board state; //packed copy of board, kept in step with every move
      
 
     Puzzle(const Puzzle &p); //Constructor
@@ -33,7 +50,7 @@ public:
      
     void printBoard();
     
-    int h(heuristicFunction hFunction);   
+    int h(heuristicFunction hFunction); //misplacedTiles or manhattanDistance, else invalid_argument
     void updateFCost(); 
     void updateHCost(heuristicFunction hFunction);
     void updateDepth(){
@@ -45,8 +62,12 @@ public:
      string toString();
     
     string getString(){
-        return strBoard;
+        return state.toString();
      }
+
+    Board getState() const{
+        return state;
+    }
     
     bool canMoveLeft();
     bool canMoveRight();
@@ -65,6 +86,22 @@ public:
     Puzzle * moveRight();
     Puzzle * moveDown();
     Puzzle * moveLeft();
+
+//----------------------------------------
+//in-place moves: no copy of the puzzle is made, and no allocation while
+//the path is shorter than PATH_ROOM
+    bool canMove(moveDirection dir) const{
+        return state.canMove(dir);
+    }
+    void applyMove(moveDirection dir); //dir must be legal
+    void undoMove(moveDirection dir);  //reverts applyMove(dir)
+//----------------------------------------
+
+private:
+
+    Puzzle * moved(moveDirection dir); //copy of this puzzle after dir, unmoved if dir is illegal
+
+public:
      
      
     const string getPath();
@@ -78,3 +115,65 @@ public:
     int getGCost(); 
     
 };
+
+
+//////////////////////////////////////////////////////
+// Visits the successors of a puzzle in URDL order without allocating:
+// next() applies the following legal move to the puzzle in place, after
+// undoing the previous one.  The puzzle is back to its original board
+// once next() returns false or the iterator goes out of scope.  The
+// engines expand packed boards with Successors<Board> (state.h); this is
+// its counterpart for code that holds a whole Puzzle.
+//
+//    SuccessorIterator<3, 3> it(p);
+//    while(it.next()){ ... p is the child reached by it.move() ... }
+//////////////////////////////////////////////////////
+template<int Rows, int Cols>
+class SuccessorIterator{
+
+private:
+
+    Puzzle<Rows, Cols> &p;
+    int dir;
+    bool applied;
+
+public:
+
+    explicit SuccessorIterator(Puzzle<Rows, Cols> &puzzle) : p(puzzle), dir(-1), applied(false) {}
+    ~SuccessorIterator(){ restore(); }
+
+    bool next(){
+        restore();
+        while(++dir <= dirLeft){
+            if(p.canMove(moveDirection(dir))){
+                p.applyMove(moveDirection(dir));
+                applied = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    moveDirection move() const{
+        return moveDirection(dir);
+    }
+
+private:
+
+    void restore(){
+        if(applied){
+            p.undoMove(moveDirection(dir));
+            applied = false;
+        }
+    }
+
+    SuccessorIterator(const SuccessorIterator &);
+    SuccessorIterator &operator=(const SuccessorIterator &);
+};
+
+
+typedef Puzzle<3, 3> Puzzle8;
+typedef Puzzle<4, 4> Puzzle15;
+typedef Puzzle<5, 5> Puzzle24;
+
+#endif
@@ -0,0 +1,122 @@
+#include "rank.h"
+
+namespace {
+
+const uint32_t FACTORIAL[10] = {1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880};
+
+const uint32_t HALF_TILE_PERMUTATIONS = 20160; // 8!/2
+
+//////////////////////////////////////////////////////////////
+// lookup tables behind the Lehmer code, indexed by the set of values
+// already placed:  how many of them lie below a value, and which value
+// is the k-th one still free
+//////////////////////////////////////////////////////////////
+struct RankTables{
+    uint8_t popcount[512];
+    int8_t  kthFree[512][9];
+
+    RankTables(){
+        for(int m = 0; m < 512; m++){
+            int c = 0, k = 0;
+            for(int b = 0; b < 9; b++){
+                kthFree[m][b] = -1;
+                if(m & (1 << b)) c++;
+            }
+            for(int b = 0; b < 9; b++){
+                if(!(m & (1 << b))) kthFree[m][k++] = int8_t(b);
+            }
+            popcount[m] = uint8_t(c);
+        }
+    }
+};
+
+const RankTables TABLES;
+
+// rank of v[0..n-1], a permutation of 0..n-1, in lexicographic order
+inline uint32_t lehmerRank(const int *v, int n){
+    uint32_t r = 0;
+    unsigned seen = 0;
+    for(int i = 0; i < n; i++){
+        int digit = v[i] - TABLES.popcount[seen & ((1u << v[i]) - 1)];
+        r += uint32_t(digit) * FACTORIAL[n - 1 - i];
+        seen |= 1u << v[i];
+    }
+    return r;
+}
+
+inline void lehmerUnrank(uint32_t r, int *v, int n){
+    unsigned used = 0;
+    for(int i = 0; i < n; i++){
+        uint32_t f = FACTORIAL[n - 1 - i];
+        v[i] = TABLES.kthFree[used][r / f];
+        r %= f;
+        used |= 1u << v[i];
+    }
+}
+
+inline int permutationParity(const int *v, int n){
+    int inversions = 0;
+    for(int i = 0; i < n; i++)
+        for(int j = i + 1; j < n; j++)
+            if(v[i] > v[j]) inversions++;
+    return inversions & 1;
+}
+
+// numbered tiles in board order, relabelled 0..7
+inline void tilesOf(PackedState s, int *v){
+    int k = 0;
+    for(int i = 0; i < 9; i++){
+        int t = s.tile(i);
+        if(t != 0) v[k++] = t - 1;
+    }
+}
+
+}
+
+
+uint32_t rankState(PackedState s){
+    int v[9];
+    for(int i = 0; i < 9; i++) v[i] = s.tile(i);
+    return lehmerRank(v, 9);
+}
+
+PackedState unrankState(uint32_t rank){
+    int v[9];
+    lehmerUnrank(rank, v, 9);
+
+    uint64_t b = 0;
+    for(int i = 0; i < 9; i++){
+        b |= uint64_t(v[i]) << (4 * i);
+        if(v[i] == 0) b |= uint64_t(i) << PackedState::BLANK_SHIFT;
+    }
+    return PackedState(b);
+}
+
+uint32_t rankSolvable(PackedState s){
+    int v[8];
+    tilesOf(s, v);
+    return uint32_t(s.blank()) * HALF_TILE_PERMUTATIONS + (lehmerRank(v, 8) >> 1);
+}
+
+PackedState unrankSolvable(uint32_t rank, int parity){
+    const int blank = int(rank / HALF_TILE_PERMUTATIONS);
+
+    int v[8];
+    lehmerUnrank((rank % HALF_TILE_PERMUTATIONS) << 1, v, 8);
+    if(permutationParity(v, 8) != parity){
+        int t = v[6]; v[6] = v[7]; v[7] = t;
+    }
+
+    uint64_t b = uint64_t(blank) << PackedState::BLANK_SHIFT;
+    int k = 0;
+    for(int i = 0; i < 9; i++){
+        if(i != blank) b |= uint64_t(v[k++] + 1) << (4 * i);
+    }
+    return PackedState(b);
+}
+
+int tileParity(PackedState s){
+    int v[8];
+    tilesOf(s, v);
+    return permutationParity(v, 8);
+}
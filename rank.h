@@ -0,0 +1,36 @@
+#ifndef __RANK_H__
+#define __RANK_H__
+
+#include <cstdint>
+#include "state.h"
+
+
+//////////////////////////////////////////////////////
+// Perfect ranking of 8-puzzle boards
+//
+// rankState() is the Lehmer-code rank of the 9 cells (blank included)
+// and maps the 9! boards onto 0 .. 9!-1.
+//
+// rankSolvable() only covers one reachable half of the boards:
+//     rank = blank * 8!/2 + lehmer(tiles without the blank) / 2
+// Boards reachable from each other share the inversion parity of their
+// 8 tiles, and swapping the last two tiles flips that parity while
+// moving the Lehmer rank between 2k and 2k+1, so within one parity class
+// the rank is dense over 0 .. 9!/2-1.  unrankSolvable() needs that parity
+// back to pick the right member of the pair.
+//////////////////////////////////////////////////////
+
+const uint32_t NUM_PERMUTATIONS = 362880; // 9!
+const uint32_t NUM_SOLVABLE     = 181440; // 9!/2
+
+uint32_t rankState(PackedState s);
+PackedState unrankState(uint32_t rank);
+
+uint32_t rankSolvable(PackedState s);
+PackedState unrankSolvable(uint32_t rank, int parity);
+
+// parity (0 even, 1 odd) of the inversions among the 8 numbered tiles
+int tileParity(PackedState s);
+
+
+#endif
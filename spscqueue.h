@@ -0,0 +1,62 @@
+#ifndef __SPSCQUEUE_H__
+#define __SPSCQUEUE_H__
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+
+//////////////////////////////////////////////////////
+// Bounded single-producer single-consumer queue.
+//
+// One thread pushes and one other thread pops, without a lock: each side
+// writes only its own index and reads the other's, and the release/acquire
+// pair on the index publishes the slot.  The indices sit a cache line
+// apart so the two threads do not fight over one line.  push() fails when
+// the ring is full; the producer keeps what did not fit and tries again.
+//////////////////////////////////////////////////////
+template <class T>
+class SpscQueue
+{
+    std::vector<T> ring;
+    size_t mask;
+
+    std::atomic<size_t> head; // next slot to pop, written by the consumer
+    char apart[64];
+    std::atomic<size_t> tail; // next slot to push, written by the producer
+
+public:
+
+    // capacity is rounded up to a power of two
+    explicit SpscQueue(size_t capacity) : head(0), tail(0)
+    {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        ring.resize(size);
+        mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    bool push(const T &v)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == ring.size()) return false;
+        ring[t & mask] = v;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &v)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        v = ring[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+
+#endif
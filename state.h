@@ -0,0 +1,394 @@
+#ifndef __STATE_H__
+#define __STATE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+//////////////////////////////////////////////////////
+// moves of the blank, in the URDL order used by the move generator
+enum moveDirection{dirUp, dirRight, dirDown, dirLeft};
+
+// letter used for each move in a solution path
+const char MOVE_CHAR[4] = {'u', 'r', 'd', 'l'};
+
+inline moveDirection inverseOf(moveDirection d){
+    return moveDirection((d + 2) & 3);
+}
+
+// direction of a path letter in either case, -1 if it is not a move
+inline int directionOf(char c){
+    switch(c){
+        case 'u': case 'U': return dirUp;
+        case 'r': case 'R': return dirRight;
+        case 'd': case 'D': return dirDown;
+        case 'l': case 'L': return dirLeft;
+    }
+    return -1;
+}
+
+// value of a tile character: '0'-'9', then 'A'.. for tiles 10 and up
+inline int tileValue(char c){
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'z') return c - 'a' + 10;
+    return c - 'A' + 10;
+}
+
+inline char tileChar(int t){
+    return char(t < 10 ? '0' + t : 'A' + t - 10);
+}
+
+// murmur3 fmix64, spreads nearby boards over the hash buckets
+inline uint64_t mix64(uint64_t x){
+    x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+//////////////////////////////////////////////////////
+// Compile-time move table of a Rows x Cols board:
+// neighbour[i][d] is the position reached by moving the blank from
+// position i in direction d (URDL), -1 if that is off the board, and
+// legal[i] has bit d set for every d that stays on it.
+//////////////////////////////////////////////////////
+template<int Rows, int Cols>
+struct Geometry{
+
+    static const int N = Rows * Cols;
+
+    struct Table{
+        signed char neighbour[Rows * Cols][4];
+        unsigned char legal[Rows * Cols];
+
+        constexpr Table() : neighbour(), legal() {
+            for(int i = 0; i < Rows * Cols; i++){
+                const int r = i / Cols, c = i % Cols;
+                neighbour[i][dirUp]    = (r > 0)        ? i - Cols : -1;
+                neighbour[i][dirRight] = (c < Cols - 1) ? i + 1    : -1;
+                neighbour[i][dirDown]  = (r < Rows - 1) ? i + Cols : -1;
+                neighbour[i][dirLeft]  = (c > 0)        ? i - 1    : -1;
+                for(int d = dirUp; d <= dirLeft; d++)
+                    if(neighbour[i][d] >= 0) legal[i] |= (unsigned char)(1 << d);
+            }
+        }
+    };
+
+    static constexpr Table TABLE{};
+
+    static int neighbour(int pos, moveDirection d){
+        return TABLE.neighbour[pos][d];
+    }
+};
+
+template<int Rows, int Cols>
+constexpr typename Geometry<Rows, Cols>::Table Geometry<Rows, Cols>::TABLE;
+
+//////////////////////////////////////////////////////
+// Packed Rows x Cols board.  The layout is picked at compile time:
+//
+// * boards whose tiles and blank index fit in 64 bits (3x3):
+//     bits 4*i .. 4*i+3 : tile at position i (0 = blank)
+//     bits 4*N ..       : position of the blank
+//
+// * larger boards (4x4, 5x5): tiles packed 4 bits each (5 bits from 17
+//   cells up) into as few words as needed, the blank index in a byte.
+//
+// Equality, hashing and moves are plain bit operations, so the search
+// never has to build or hash strings.
+//////////////////////////////////////////////////////
+template<int Rows, int Cols, bool OneWord = (Rows * Cols * 4 + 4 <= 64)>
+struct PackedBoard{
+
+    static const int ROWS = Rows;
+    static const int COLS = Cols;
+    static const int N = Rows * Cols;
+    static const int BITS = (N <= 16) ? 4 : 5;
+    static const int PER_WORD = 64 / BITS;
+    static const int WORDS = (N + PER_WORD - 1) / PER_WORD;
+    static const uint64_t MASK = (uint64_t(1) << BITS) - 1;
+
+    uint64_t word[WORDS];
+    uint8_t blankPos;
+
+    PackedBoard() : word(), blankPos(0) {}
+
+    int tile(int pos) const {
+        return int((word[pos / PER_WORD] >> (BITS * (pos % PER_WORD))) & MASK);
+    }
+
+    int blank() const {
+        return blankPos;
+    }
+
+    void set(int pos, int t){
+        uint64_t &w = word[pos / PER_WORD];
+        const int shift = BITS * (pos % PER_WORD);
+        w = (w & ~(MASK << shift)) | (uint64_t(t) << shift);
+        if(t == 0) blankPos = uint8_t(pos);
+    }
+
+    bool canMove(moveDirection d) const {
+        return Geometry<Rows, Cols>::neighbour(blankPos, d) >= 0;
+    }
+
+    // slides the neighbouring tile into the blank; canMove(d) must hold
+    PackedBoard moved(moveDirection d) const {
+        const int from = blankPos;
+        const int to   = Geometry<Rows, Cols>::neighbour(from, d);
+        PackedBoard b(*this);
+        b.set(from, tile(to));
+        b.set(to, 0);
+        return b;
+    }
+
+    bool operator==(const PackedBoard &o) const {
+        for(int i = 0; i < WORDS; i++)
+            if(word[i] != o.word[i]) return false;
+        return blankPos == o.blankPos;
+    }
+    bool operator!=(const PackedBoard &o) const { return !(*this == o); }
+
+    size_t hash() const {
+        uint64_t h = blankPos;
+        for(int i = 0; i < WORDS; i++) h = mix64(h ^ word[i]);
+        return size_t(h);
+    }
+
+    static PackedBoard fromString(const std::string &s){
+        PackedBoard b;
+        for(int i = 0; i < N; i++) b.set(i, tileValue(s[i]));
+        return b;
+    }
+
+    std::string toString() const {
+        std::string s(N, '0');
+        for(int i = 0; i < N; i++) s[i] = tileChar(tile(i));
+        return s;
+    }
+};
+
+template<int Rows, int Cols>
+struct PackedBoard<Rows, Cols, true>{
+
+    static const int ROWS = Rows;
+    static const int COLS = Cols;
+    static const int N = Rows * Cols;
+    static const int BLANK_SHIFT = 4 * N;
+    static const uint64_t TILE_MASK = (uint64_t(1) << BLANK_SHIFT) - 1;
+
+    uint64_t bits;
+
+    PackedBoard() : bits(0) {}
+    explicit PackedBoard(uint64_t b) : bits(b) {}
+
+    int tile(int pos) const {
+        return int((bits >> (4 * pos)) & 0xF);
+    }
+
+    int blank() const {
+        return int(bits >> BLANK_SHIFT);
+    }
+
+    void set(int pos, int t){
+        bits = (bits & ~(uint64_t(0xF) << (4 * pos))) | (uint64_t(t) << (4 * pos));
+        if(t == 0) bits = (bits & TILE_MASK) | (uint64_t(pos) << BLANK_SHIFT);
+    }
+
+    bool canMove(moveDirection d) const {
+        return Geometry<Rows, Cols>::neighbour(blank(), d) >= 0;
+    }
+
+    // slides the neighbouring tile into the blank; canMove(d) must hold
+    PackedBoard moved(moveDirection d) const {
+        const int from = blank();
+        const int to   = Geometry<Rows, Cols>::neighbour(from, d);
+        const uint64_t t = (bits >> (4 * to)) & 0xF;
+        uint64_t tiles = (bits & TILE_MASK) - (t << (4 * to)) + (t << (4 * from));
+        return PackedBoard(tiles | (uint64_t(to) << BLANK_SHIFT));
+    }
+
+    bool operator==(const PackedBoard &o) const { return bits == o.bits; }
+    bool operator!=(const PackedBoard &o) const { return bits != o.bits; }
+
+    size_t hash() const {
+        return size_t(mix64(bits));
+    }
+
+    static PackedBoard fromString(const std::string &s){
+        PackedBoard b;
+        for(int i = 0; i < N; i++) b.set(i, tileValue(s[i]));
+        return b;
+    }
+
+    std::string toString() const {
+        std::string s(N, '0');
+        for(int i = 0; i < N; i++) s[i] = tileChar(tile(i));
+        return s;
+    }
+};
+
+template<class Board>
+struct BoardHash{
+    size_t operator()(const Board &b) const { return b.hash(); }
+};
+
+typedef PackedBoard<3, 3> PackedState;
+typedef BoardHash<PackedState> PackedStateHash;
+
+//////////////////////////////////////////////////////
+// Move generator of the best-first engines.
+//
+// Writes the children of a board, in URDL order, into a fixed array of
+// four: the legal moves come from the move table by blank position, and
+// no child is ever allocated.  Moves whose bit is set in the pruning mask
+// are left out and counted in pruned; pruneMaskAfter(m) is the mask that
+// drops the move undoing m.
+//////////////////////////////////////////////////////
+inline unsigned pruneMaskAfter(int lastMove){
+    return lastMove < 0 ? 0u : 1u << inverseOf(moveDirection(lastMove));
+}
+
+template<class Board>
+struct Successors{
+
+    struct Child{
+        Board state;
+        moveDirection move;
+    };
+
+    Child child[4];
+    int count;
+    int pruned; // legal moves the mask left out
+
+    Successors(const Board &b, unsigned pruneMask) : count(0) {
+        const unsigned legal = Geometry<Board::ROWS, Board::COLS>::TABLE.legal[b.blank()];
+        const unsigned kept = legal & ~pruneMask;
+        pruned = __builtin_popcount(legal & pruneMask);
+        for(int d = dirUp; d <= dirLeft; d++){
+            if(!(kept & (1u << d))) continue;
+            child[count].state = b.moved(moveDirection(d));
+            child[count].move = moveDirection(d);
+            count++;
+        }
+    }
+
+    const Child *begin() const { return child; }
+    const Child *end() const { return child + count; }
+};
+
+//////////////////////////////////////////////////////
+// Goal relabeling.
+//
+// Renaming tiles changes neither the moves of the blank nor the Manhattan
+// or misplaced-tiles costs, so the query (start, goal) has exactly the
+// solutions of (apply(start), apply(goal)), where apply() renames goal's
+// tile on every square to the canonical goal's tile on that square.  The
+// canonical goal keeps the blank where goal has it and numbers the other
+// squares 1, 2, ... in reading order ("123456780" maps to itself), so one
+// table per blank square serves every goal.
+//////////////////////////////////////////////////////
+inline std::string canonicalGoal(int cells, int blank){
+    std::string g(cells, '0');
+    int t = 1;
+    for(int i = 0; i < cells; i++)
+        if(i != blank) g[i] = tileChar(t++);
+    return g;
+}
+
+// the canonical goal as a board
+template<int Rows, int Cols>
+PackedBoard<Rows, Cols> canonicalBoard(int blank){
+    PackedBoard<Rows, Cols> b;
+    for(int i = 0, t = 1; i < Rows * Cols; i++) b.set(i, i == blank ? 0 : t++);
+    return b;
+}
+
+class GoalRelabeling{
+    int cells;
+    int label[32]; // [tile in goal] -> canonical tile, -1 if goal lacks it
+
+public:
+
+    explicit GoalRelabeling(const std::string &goal) : cells(goal.size() <= 32 ? (int)goal.size() : 0) {
+        for(int t = 0; t < 32; t++) label[t] = -1;
+
+        int blank = 0;
+        for(int i = 0; i < cells; i++)
+            if(tileValue(goal[i]) == 0) blank = i;
+        const std::string canonical = canonicalGoal(cells, blank);
+
+        for(int i = 0; i < cells; i++){
+            const int t = tileValue(goal[i]);
+            if(t >= 0 && t < cells) label[t] = tileValue(canonical[i]);
+        }
+    }
+
+    // canonical name of tile t of the goal, -1 if the goal lacks it
+    int name(int t) const { return t >= 0 && t < 32 ? label[t] : -1; }
+
+    // s renamed, "" unless s holds every tile 0 .. cells-1 exactly once
+    // (so apply(goal) is "" when goal itself is malformed)
+    std::string apply(const std::string &s) const {
+        if((int)s.size() != cells) return "";
+        std::string r(cells, '0');
+        unsigned seen = 0;
+        for(int i = 0; i < cells; i++){
+            const int t = tileValue(s[i]);
+            if(t < 0 || t >= cells || label[t] < 0 || (seen & (1u << t))) return "";
+            seen |= 1u << t;
+            r[i] = tileChar(label[t]);
+        }
+        return r;
+    }
+};
+
+//////////////////////////////////////////////////////
+// Solvability test by permutation parity, O(n).
+//
+// Every move swaps the blank with a neighbour: one transposition of the
+// cells, and one step of the blank's taxicab distance to its goal square.
+// So start reaches goal exactly when the permutation taking start to goal
+// (blank included) has the parity of that distance.  For odd widths this
+// is the usual "equal tile inversions" rule, and for even widths the
+// "inversions plus blank row" rule.  Parity is read off the cycle count.
+//////////////////////////////////////////////////////
+inline bool isSolvable(const int *start, const int *goal, int rows, int cols){
+    const int n = rows * cols;
+    int goalPos[32];
+    int target[32];
+    bool seen[32];
+
+    int startBlank = 0;
+
+    for(int i = 0; i < n; i++) goalPos[goal[i]] = i;
+    for(int i = 0; i < n; i++){
+        target[i] = goalPos[start[i]];
+        seen[i] = false;
+        if(start[i] == 0) startBlank = i;
+    }
+
+    int cycles = 0;
+    for(int i = 0; i < n; i++){
+        if(seen[i]) continue;
+        cycles++;
+        for(int j = i; !seen[j]; j = target[j]) seen[j] = true;
+    }
+
+    const int from = startBlank, to = goalPos[0];
+    const int blankDistance = abs(from / cols - to / cols) + abs(from % cols - to % cols);
+    return ((n - cycles) & 1) == (blankDistance & 1);
+}
+
+template<class Board>
+inline bool isSolvable(const Board &start, const Board &goal){
+    int s[Board::N], g[Board::N];
+    for(int i = 0; i < Board::N; i++){
+        s[i] = start.tile(i);
+        g[i] = goal.tile(i);
+    }
+    return isSolvable(s, g, Board::ROWS, Board::COLS);
+}
+
+#endif
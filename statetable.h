@@ -0,0 +1,128 @@
+#ifndef __STATETABLE_H__
+#define __STATETABLE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "state.h"
+
+
+//////////////////////////////////////////////////////
+// Open-addressing hash table from packed boards to Value.
+//
+// Robin Hood linear probing: an entry being inserted takes the slot of
+// any entry that sits closer to its own home slot, so probe lengths stay
+// short and even, and a lookup can stop as soon as it meets an entry
+// closer to home than the key would be.  The slots are one flat array,
+// kept below 7/8 full, with no per-entry allocation.
+//
+// operator[] finds or inserts in one probe sequence.  Like any rehashing
+// table, inserting may move entries, so a reference into the table is
+// only good until the next insertion.
+//////////////////////////////////////////////////////
+template <class Key, class Value, class Hash = BoardHash<Key>>
+class StateTable
+{
+    struct Slot
+    {
+        Key key;
+        Value value;
+        uint32_t dist = 0; // 1 + distance from the home slot, 0 if empty
+    };
+
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    size_t count = 0;
+
+    size_t home(const Key &k) const { return Hash()(k) & mask; }
+
+    // carries s on from slot i, trading places with every entry nearer home
+    void settle(Slot s, size_t i)
+    {
+        for (;; i = (i + 1) & mask, s.dist++) {
+            Slot &t = slots[i];
+            if (t.dist == 0) {
+                t = s;
+                return;
+            }
+            if (t.dist < s.dist) std::swap(t, s);
+        }
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<Slot> old(capacity);
+        old.swap(slots);
+        mask = capacity - 1;
+        for (Slot &s : old) {
+            if (s.dist == 0) continue;
+            s.dist = 1;
+            settle(s, home(s.key));
+        }
+    }
+
+public:
+
+    // sized so that expected entries fit without rehashing
+    explicit StateTable(size_t expected = 1024)
+    {
+        size_t capacity = 16;
+        while (capacity * 7 < expected * 8) capacity <<= 1;
+        slots.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    const Value *find(const Key &k) const
+    {
+        size_t i = home(k);
+        for (uint32_t dist = 1;; i = (i + 1) & mask, dist++) {
+            const Slot &t = slots[i];
+            if (t.dist < dist) return nullptr;
+            if (t.dist == dist && t.key == k) return &t.value;
+        }
+    }
+
+    Value *find(const Key &k)
+    {
+        return const_cast<Value *>(static_cast<const StateTable &>(*this).find(k));
+    }
+
+    // value of k, default-constructed first if k is new
+    Value &operator[](const Key &k)
+    {
+        if ((count + 1) * 8 > slots.size() * 7) rehash(slots.size() * 2);
+
+        size_t i = home(k);
+        for (uint32_t dist = 1;; i = (i + 1) & mask, dist++) {
+            Slot &t = slots[i];
+            if (t.dist == dist && t.key == k) return t.value;
+            if (t.dist < dist) { // k is absent and belongs here
+                if (t.dist != 0) {
+                    Slot displaced = t;
+                    displaced.dist++;
+                    settle(displaced, (i + 1) & mask);
+                }
+                t.key = k;
+                t.value = Value();
+                t.dist = dist;
+                count++;
+                return t.value;
+            }
+        }
+    }
+
+    size_t size() const { return count; }
+
+    // empties the table, keeping its slots: one pass over the slot array,
+    // which stays as large as the biggest search so far made it
+    void clear()
+    {
+        if (count == 0) return;
+        for (Slot &s : slots) s.dist = 0;
+        count = 0;
+    }
+};
+
+
+#endif
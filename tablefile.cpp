@@ -0,0 +1,142 @@
+#include "tablefile.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined __unix__ || defined __APPLE__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define TABLE_USE_MMAP 1
+#endif
+
+static const char TABLE_MAGIC[8] = {'P', 'U', 'Z', 'T', 'A', 'B', 'L', 'E'};
+
+static_assert(sizeof(TableHeader) == 128, "table header must stay 128 bytes");
+
+
+static uint64_t fnv1a(uint64_t h, const uint8_t *data, size_t n){
+    for(size_t i = 0; i < n; i++){
+        h ^= data[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+
+uint64_t tableChecksum(const TableHeader &header, const uint8_t *data, size_t n){
+    TableHeader h = header;
+    h.checksum = 0;
+    return fnv1a(fnv1a(0xcbf29ce484222325ULL, reinterpret_cast<const uint8_t*>(&h), sizeof(h)), data, n);
+}
+
+
+// the goal's cells hold every tile 0 .. cells-1 once
+static bool goalOK(const TableHeader &h){
+    const int cells = int(h.rows) * int(h.cols);
+    if(cells < 2 || cells > int(sizeof(h.goal))) return false;
+    uint32_t seen = 0;
+    for(int i = 0; i < cells; i++){
+        if(h.goal[i] >= cells || (seen >> h.goal[i]) & 1) return false;
+        seen |= 1u << h.goal[i];
+    }
+    return true;
+}
+
+
+bool writeTableFile(const std::string &path, TableHeader header, const uint8_t *data, size_t n,
+                    std::string &error){
+    memcpy(header.magic, TABLE_MAGIC, sizeof(TABLE_MAGIC));
+    header.version = TABLE_FORMAT_VERSION;
+    header.entries = n;
+    header.checksum = tableChecksum(header, data, n);
+
+    FILE *f = fopen(path.c_str(), "wb");
+    if(f == NULL){
+        error = "cannot create " + path;
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(data, 1, n, f) == n;
+    ok = (fclose(f) == 0) && ok;
+    if(!ok) error = "cannot write " + path;
+    return ok;
+}
+
+
+bool MappedTable::open(const std::string &path, std::string &error){
+    close();
+
+#ifdef TABLE_USE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(TableHeader)){
+        ::close(fd);
+        error = path + " is not a table file";
+        return false;
+    }
+    void *p = mmap(NULL, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(p == MAP_FAILED){
+        error = "cannot map " + path;
+        return false;
+    }
+    base = static_cast<const uint8_t*>(p);
+    length = size_t(st.st_size);
+#else
+    FILE *f = fopen(path.c_str(), "rb");
+    if(f == NULL){
+        error = "cannot open " + path;
+        return false;
+    }
+    uint8_t chunk[65536];
+    size_t got;
+    while((got = fread(chunk, 1, sizeof(chunk), f)) > 0) buffer.insert(buffer.end(), chunk, chunk + got);
+    fclose(f);
+    if(buffer.size() < sizeof(TableHeader)){
+        buffer.clear();
+        error = path + " is not a table file";
+        return false;
+    }
+    base = buffer.data();
+    length = buffer.size();
+#endif
+
+    const TableHeader &h = header();
+    if(memcmp(h.magic, TABLE_MAGIC, sizeof(TABLE_MAGIC)) != 0){
+        error = path + " is not a table file";
+    }
+    else if(h.version != TABLE_FORMAT_VERSION){
+        error = path + " has table format version " + std::to_string(h.version) +
+                ", expected " + std::to_string(TABLE_FORMAT_VERSION);
+    }
+    else if(h.entries != length - sizeof(TableHeader)){
+        error = path + " is truncated";
+    }
+    else if(!goalOK(h)){
+        error = path + " has a goal that is not a permutation";
+    }
+    else {
+        return true;
+    }
+    close();
+    return false;
+}
+
+
+void MappedTable::close(){
+#ifdef TABLE_USE_MMAP
+    if(base != nullptr) munmap(const_cast<uint8_t*>(base), length);
+#endif
+    buffer.clear();
+    base = nullptr;
+    length = 0;
+}
+
+
+bool MappedTable::checksumOK() const {
+    return isOpen() && tableChecksum(header(), data(), size_t(header().entries)) == header().checksum;
+}
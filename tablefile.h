@@ -0,0 +1,74 @@
+#ifndef __TABLEFILE_H__
+#define __TABLEFILE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+//////////////////////////////////////////////////////
+// On-disk format of precomputed tables (distance tables, pattern
+// databases): a fixed 128-byte header followed by one byte per entry.
+//
+// Tables are opened with mmap where available, so their pages fault in
+// only when a lookup touches them and every process using the same file
+// shares one copy in the page cache.  Elsewhere (Windows) the data is
+// read into memory instead.
+//
+// open() checks the header against the file size and the goal for a
+// permutation, touching nothing but the header.  checksumOK() reads the
+// whole file and compares it with the stored FNV-1a checksum; it is left
+// to an explicit verify step, since a load would otherwise fault in every
+// page of a table that lookups only sample.
+//////////////////////////////////////////////////////
+
+const uint32_t TABLE_FORMAT_VERSION = 2;
+
+enum tableKind{distanceTableFile = 1, patternDatabaseFile = 2};
+
+struct TableHeader{
+    char     magic[8];          // "PUZTABLE"
+    uint32_t version;           // TABLE_FORMAT_VERSION
+    uint8_t  kind;              // tableKind
+    uint8_t  rows, cols;
+    uint8_t  reserved;
+    uint8_t  goal[32];          // goal tiles in board order
+    uint8_t  partition[32];     // pattern of each tile, 0 if not in it (pattern databases)
+    uint64_t entries;           // bytes of data after the header
+    uint64_t checksum;          // FNV-1a 64 of the header, this field zeroed, and the data
+    uint8_t  padding[32];
+};
+
+uint64_t tableChecksum(const TableHeader &header, const uint8_t *data, size_t n);
+
+// fills in magic, version and checksum, and writes header + data
+bool writeTableFile(const std::string &path, TableHeader header, const uint8_t *data, size_t n,
+                    std::string &error);
+
+
+class MappedTable
+{
+    const uint8_t *base = nullptr;  // start of the file
+    size_t length = 0;
+    std::vector<uint8_t> buffer;    // file contents when mmap is not available
+
+public:
+
+    MappedTable() {}
+    MappedTable(const MappedTable &) = delete;
+    MappedTable &operator=(const MappedTable &) = delete;
+    ~MappedTable() { close(); }
+
+    bool open(const std::string &path, std::string &error);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    const TableHeader &header() const { return *reinterpret_cast<const TableHeader*>(base); }
+    const uint8_t *data() const { return base + sizeof(TableHeader); }
+
+    bool checksumOK() const;
+};
+
+
+#endif
@@ -0,0 +1,82 @@
+#include "walkingdistance.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+using namespace std;
+
+
+// three bits per count, line by line, then the blank's line
+uint64_t WalkingDistance::encode(const int *count, int blankLine) const {
+    uint64_t code = uint64_t(blankLine);
+    for(int i = 0; i < lines * lines; i++) code = (code << 3) | uint64_t(count[i]);
+    return code;
+}
+
+
+WalkingDistance::WalkingDistance(int lines, int length, int blankLine) : lines(lines), length(length) {
+    if(lines < 2 || lines > MAX_LINES || length < 2 || length > MAX_LINES)
+        throw invalid_argument("walking distance is tabled for boards up to 4x4 only");
+
+    int count[MAX_LINES * MAX_LINES] = {};
+    for(int l = 0; l < lines; l++) count[l * lines + l] = (l == blankLine) ? length - 1 : length;
+
+    vector<uint64_t> codes;
+    vector<int> blankOf;
+    codes.push_back(encode(count, blankLine));
+    blankOf.push_back(blankLine);
+    idOf[codes[0]] = 0;
+    dist.push_back(0);
+
+    // codes doubles as the BFS queue: ids are handed out in visiting order
+    for(size_t id = 0; id < codes.size(); id++){
+        uint64_t code = codes[id];
+        for(int i = lines * lines - 1; i >= 0; i--, code >>= 3) count[i] = int(code & 7);
+        const int b = blankOf[id];
+
+        next.resize((id + 1) * 2 * lines, -1);
+        for(int side = 0; side < 2; side++){
+            const int nb = side == 0 ? b - 1 : b + 1;
+            if(nb < 0 || nb >= lines) continue;
+
+            for(int g = 0; g < lines; g++){
+                if(count[nb * lines + g] == 0) continue;
+                count[nb * lines + g]--;
+                count[b * lines + g]++;
+
+                const uint64_t c = encode(count, nb);
+                unordered_map<uint64_t, int>::const_iterator it = idOf.find(c);
+                int child;
+                if(it == idOf.end()){
+                    child = int(codes.size());
+                    idOf[c] = child;
+                    codes.push_back(c);
+                    blankOf.push_back(nb);
+                    dist.push_back(uint8_t(dist[id] + 1));
+                }
+                else child = it->second;
+                next[(id * 2 + side) * lines + g] = child;
+
+                count[b * lines + g]--;
+                count[nb * lines + g]++;
+            }
+        }
+    }
+}
+
+
+shared_ptr<const WalkingDistance> WalkingDistance::shared(int lines, int length, int blankLine){
+    static mutex lock;
+    static map<int, shared_ptr<const WalkingDistance>> built;  // a few small tables, kept for good
+
+    lock_guard<mutex> guard(lock);
+    shared_ptr<const WalkingDistance> &table = built[(lines * 8 + length) * 8 + blankLine];
+    if(!table) table = make_shared<const WalkingDistance>(lines, length, blankLine);
+    return table;
+}
+
+
+int WalkingDistance::id(const int *count, int blankLine) const {
+    return idOf.find(encode(count, blankLine))->second;
+}
@@ -0,0 +1,134 @@
+#ifndef __WALKINGDISTANCE_H__
+#define __WALKINGDISTANCE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+//////////////////////////////////////////////////////
+// Walking distance.
+//
+// Seen only row by row, a board is a matrix count[line][goalLine]: how
+// many tiles on each row belong on each row, plus the row of the blank.
+// A vertical move carries one tile from the blank's neighbouring row into
+// the blank's row.  The fewest such moves from a matrix back to the goal's
+// matrix is a lower bound on the vertical moves still needed; doing the
+// same with columns bounds the horizontal ones, and the two add up.
+//
+// A breadth-first search from the goal's matrix numbers every reachable
+// matrix and stores its distance and, for each way the blank can leave its
+// line, the number of the matrix it leads to.  A search that moves one
+// tile at a time follows those links instead of looking matrices up.
+//////////////////////////////////////////////////////
+class WalkingDistance
+{
+public:
+
+    static const int MAX_LINES = 4;
+
+private:
+
+    int lines, length;
+    std::unordered_map<uint64_t, int> idOf;
+    std::vector<uint8_t> dist;  // [id]
+    std::vector<int> next;      // [(id * 2 + side) * lines + goalLine], -1 if no such move
+
+    uint64_t encode(const int *count, int blankLine) const;
+
+public:
+
+    // lines of length squares each, blank on blankLine in the goal
+    WalkingDistance(int lines, int length, int blankLine);
+
+    // built on first use, shared by every thread and kept until exit
+    static std::shared_ptr<const WalkingDistance> shared(int lines, int length, int blankLine);
+
+    // count[line * lines + goalLine] as above
+    int id(const int *count, int blankLine) const;
+    int distance(int id) const { return dist[id]; }
+
+    // matrix after the blank moves to the line before (side 0) or after
+    // (side 1) its own, past a tile whose goal is on goalLine
+    int after(int id, int side, int goalLine) const { return next[(id * 2 + side) * lines + goalLine]; }
+
+    size_t size() const { return dist.size(); }
+};
+
+
+//////////////////////////////////////////////////////
+// Walking distance of a Rows x Cols board towards one goal, by rows and
+// by columns.  reset() and moveTile() keep the two matrix numbers of one
+// board up to date for the depth-first engine.  The two tables belong to
+// the caller and must outlive the WalkingCost.
+//////////////////////////////////////////////////////
+template<int Rows, int Cols>
+class WalkingCost
+{
+    static const int N = Rows * Cols;
+
+    const WalkingDistance *rows = nullptr, *cols = nullptr;
+    int goalRow[N], goalCol[N];
+    int rowId = 0, colId = 0;
+
+    // tile t slid from square from to the neighbouring square to
+    void step(int &r, int &c, int t, int from, int to) const {
+        if(from / Cols == to / Cols) c = cols->after(c, from % Cols < to % Cols ? 0 : 1, goalCol[t]);
+        else r = rows->after(r, from / Cols < to / Cols ? 0 : 1, goalRow[t]);
+    }
+
+public:
+
+    // matrix numbers of a whole board, by rows and by columns
+    template<class Cells>
+    void ids(const Cells &b, int &r, int &c) const {
+        int byRow[Rows * Rows] = {}, byCol[Cols * Cols] = {};
+        int blank = 0;
+        for(int i = 0; i < N; i++){
+            const int t = b.tile(i);
+            if(t == 0){ blank = i; continue; }
+            byRow[(i / Cols) * Rows + goalRow[t]]++;
+            byCol[(i % Cols) * Cols + goalCol[t]]++;
+        }
+        r = rows->id(byRow, blank / Cols);
+        c = cols->id(byCol, blank % Cols);
+    }
+
+    // byRow and byCol as handed out by WalkingDistance::shared() for goal
+    template<class Board>
+    void init(const Board &goal, const WalkingDistance &byRow, const WalkingDistance &byCol){
+        for(int i = 0; i < N; i++){
+            goalRow[goal.tile(i)] = i / Cols;
+            goalCol[goal.tile(i)] = i % Cols;
+        }
+        rows = &byRow;
+        cols = &byCol;
+    }
+
+    template<class Cells>
+    int evaluate(const Cells &b) const {
+        int r, c;
+        ids(b, r, c);
+        return rows->distance(r) + cols->distance(c);
+    }
+
+    template<class Cells>
+    void reset(const Cells &b){ ids(b, rowId, colId); }
+
+    // tile t slid from square from to the neighbouring square to
+    void moveTile(int t, int from, int to){ step(rowId, colId, t, from, to); }
+
+    int value() const { return rows->distance(rowId) + cols->distance(colId); }
+
+    // value of the board with matrices r and c once tile t slides from
+    // square from to the neighbouring square to
+    int valueAfter(int r, int c, int t, int from, int to) const {
+        step(r, c, t, from, to);
+        return rows->distance(r) + cols->distance(c);
+    }
+};
+
+
+#endif
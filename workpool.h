@@ -0,0 +1,97 @@
+#ifndef __WORKPOOL_H__
+#define __WORKPOOL_H__
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+//////////////////////////////////////////////////////
+// Work-stealing pool for a fixed set of independent jobs.
+//
+// Job i is dealt to worker i % threads, so each worker owns the jobs
+// w, w + threads, w + 2 * threads, ... as a deque of slots.  A worker
+// takes its own jobs from the front, lowest number first; once its deque
+// is empty it steals from the back of the others'.  Jobs therefore finish
+// roughly in number order, which keeps the reordering done by the caller
+// small, and a worker stuck on one hard instance does not hold up the
+// easy ones queued behind it.  The lowest job not yet taken is always at
+// the front of its owner's deque, and that owner is not busy with a higher
+// job of its own, so a caller may make a job wait for every lower one to
+// finish without the pool locking up.
+//
+// No job is ever added, so a worker that finds every deque empty is done.
+// The calling thread is worker 0; with one thread nothing is spawned.
+// An exception thrown by a job stops the hand-out and is rethrown once
+// every worker has returned.
+//////////////////////////////////////////////////////
+class WorkStealingPool
+{
+    struct Deque
+    {
+        std::mutex lock;
+        size_t front = 0, back = 0;  // slots not yet taken
+        char apart[64];              // keep neighbouring deques off one cache line
+    };
+
+    static bool take(Deque &d, bool own, size_t &slot)
+    {
+        std::lock_guard<std::mutex> guard(d.lock);
+        if (d.front == d.back) return false;
+        slot = own ? d.front++ : --d.back;
+        return true;
+    }
+
+public:
+
+    // calls job(i, worker) once for every i < count, worker < threads
+    template <class Job>
+    static void run(size_t count, int threads, Job &&job)
+    {
+        if (threads < 1) threads = 1;
+        if (size_t(threads) > count) threads = count > 0 ? int(count) : 1;
+
+        std::unique_ptr<Deque[]> deques(new Deque[threads]);
+        for (int w = 0; w < threads; w++) deques[w].back = (count + threads - 1 - w) / threads;
+
+        std::atomic<bool> failed(false);
+        std::exception_ptr error;
+        std::mutex errorLock;
+
+        auto work = [&](int w) {
+            try {
+                size_t slot;
+                while (!failed.load(std::memory_order_relaxed)) {
+                    if (take(deques[w], true, slot)) {
+                        job(slot * threads + w, w);
+                        continue;
+                    }
+                    int victim = -1;
+                    for (int k = 1; k < threads && victim < 0; k++)
+                        if (take(deques[(w + k) % threads], false, slot)) victim = (w + k) % threads;
+                    if (victim < 0) return;
+                    job(slot * threads + victim, w);
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if (!error) error = std::current_exception();
+                failed = true;
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int w = 1; w < threads; w++) workers.emplace_back(work, w);
+        work(0);
+        for (std::thread &t : workers) t.join();
+
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+
+#endif